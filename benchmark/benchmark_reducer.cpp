@@ -58,6 +58,26 @@ namespace xt
         BENCHMARK_CAPTURE(reducer_immediate_reducer, 100000x10/axis 0, v, res0, axis1);
         BENCHMARK_CAPTURE(reducer_immediate_reducer, 100000x10/axis both, v, res2, axis_both);
 
+        template <class E, class X, class S>
+        void reducer_summation(benchmark::State& state, const E& x, E& res, const X& axes, S summation_mode)
+        {
+            for (auto _ : state)
+            {
+                res = sum(x, axes, summation_mode | evaluation_strategy::immediate);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        xarray<float> fu = ones<float>({ 10, 100000 });
+        static auto fres0 = xarray<float>::from_shape({ 100000 });
+        static auto fres1 = xarray<float>::from_shape({ 10 });
+
+        BENCHMARK_CAPTURE(reducer_summation, 10x100000/axis 1/naive, fu, fres1, axis1, summation::naive);
+        BENCHMARK_CAPTURE(reducer_summation, 10x100000/axis 1/pairwise, fu, fres1, axis1, summation::pairwise);
+        BENCHMARK_CAPTURE(reducer_summation, 10x100000/axis 1/kahan, fu, fres1, axis1, summation::kahan);
+        BENCHMARK_CAPTURE(reducer_summation, 10x100000/axis 0/naive, fu, fres0, axis0, summation::naive);
+        BENCHMARK_CAPTURE(reducer_summation, 10x100000/axis 0/kahan, fu, fres0, axis0, summation::kahan);
+
         template <class E, class X>
         inline auto reducer_manual_strided_reducer(benchmark::State& state, const E& x, E& res, const X& axes)
         {
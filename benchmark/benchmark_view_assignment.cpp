@@ -8,11 +8,13 @@
 
 #include <benchmark/benchmark.h>
 
+#include "xtensor/xexecution.hpp"
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xarray.hpp"
 #include "xtensor/xfixed.hpp"
 #include "xtensor/xrandom.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -147,6 +149,30 @@ namespace xt
         }
     }
 
+    template <class P>
+    inline void assign_strided_view_mixed_layout(benchmark::State& state, P policy)
+    {
+        std::size_t n = static_cast<std::size_t>(state.range(0));
+        xt::xtensor<double, 2, layout_type::row_major> a = xt::zeros<double>({n, n + 16});
+        xt::xtensor<double, 2, layout_type::column_major> b = xt::random::rand<double>({n, n});
+        for (auto _ : state)
+        {
+            xt::noalias(xt::view(a, all(), range(8, n + 8)), policy) = 2. * b + 1.;
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n * n));
+    }
+
+    inline void assign_strided_view_mixed_layout_seq(benchmark::State& state)
+    {
+        assign_strided_view_mixed_layout(state, xt::execution::seq);
+    }
+
+    inline void assign_strided_view_mixed_layout_par(benchmark::State& state)
+    {
+        assign_strided_view_mixed_layout(state, xt::execution::par);
+    }
+
     BENCHMARK(create_xview);
     BENCHMARK(create_strided_view_outofplace);
     BENCHMARK(create_strided_view_inplace);
@@ -156,4 +182,6 @@ namespace xt
     BENCHMARK(assign_create_manual_view);
     BENCHMARK(data_offset);
     BENCHMARK(data_offset_view);
+    BENCHMARK(assign_strided_view_mixed_layout_seq)->RangeMultiplier(4)->Range(256, 1 << 13)->UseRealTime();
+    BENCHMARK(assign_strided_view_mixed_layout_par)->RangeMultiplier(4)->Range(256, 1 << 13)->UseRealTime();
 }
\ No newline at end of file
@@ -15,10 +15,15 @@
 #include <numeric>
 #include <type_traits>
 
+#include "xexecution.hpp"
 #include "xexpression.hpp"
+#include "xoperation.hpp"
+#include "xreducer.hpp"
+#include "xstorage.hpp"
 #include "xstrides.hpp"
 #include "xtensor_config.hpp"
 #include "xtensor_forward.hpp"
+#include "xtensor_simd.hpp"
 
 namespace xt
 {
@@ -150,48 +155,223 @@ namespace xt
         template <class T, class R>
         using xaccumulator_linear_return_type_t = typename xaccumulator_linear_return_type<T, R>::type;
 
-        template <class F, class E>
-        inline auto accumulator_init_with_f(F&& f, E& e, std::size_t axis)
+        template <class AF, class R, class = void>
+        struct has_accumulate_simd_apply : std::false_type
+        {
+        };
+
+        template <class AF, class R>
+        struct has_accumulate_simd_apply<AF, R, void_t<decltype(std::declval<const AF&>().simd_apply(std::declval<xt_simd::simd_type<R>>(),
+                                                                                                      std::declval<xt_simd::simd_type<R>>()))>>
+            : std::true_type
+        {
+        };
+
+        template <class AF, class R, class V>
+        struct use_simd_accumulation
+            : xtl::conjunction<std::is_same<R, V>,
+                               std::is_arithmetic<R>,
+                               has_simd_type<R>,
+                               has_accumulate_simd_apply<AF, R>>
+        {
+        };
+
+        // out[i] = acc(prev[i], in[i]); in and out may alias
+        template <class AF, class R, class V>
+        inline void accumulate_row(AF& acc, const R* prev, const V* in, R* out, std::size_t size, std::false_type /*simd*/)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                out[i] = static_cast<R>(acc(prev[i], in[i]));
+            }
+        }
+
+        template <class AF, class R>
+        inline void accumulate_row(AF& acc, const R* prev, const R* in, R* out, std::size_t size, std::true_type /*simd*/)
+        {
+            constexpr std::size_t simd_size = xt_simd::simd_traits<R>::size;
+            std::size_t i = 0;
+            for (; i + simd_size <= size; i += simd_size)
+            {
+                auto lhs = xt_simd::load_simd<R, R>(prev + i, xt_simd::unaligned_mode());
+                auto rhs = xt_simd::load_simd<R, R>(in + i, xt_simd::unaligned_mode());
+                xt_simd::store_simd<R, R>(out + i, acc.simd_apply(lhs, rhs), xt_simd::unaligned_mode());
+            }
+            accumulate_row(acc, prev + i, in + i, out + i, size - i, std::false_type());
+        }
+
+        // out[i] = acc(value, out[i])
+        template <class AF, class R>
+        inline void accumulate_value(AF& acc, const R& value, R* out, std::size_t size, std::false_type /*simd*/)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                out[i] = static_cast<R>(acc(value, out[i]));
+            }
+        }
+
+        template <class AF, class R>
+        inline void accumulate_value(AF& acc, const R& value, R* out, std::size_t size, std::true_type /*simd*/)
+        {
+            constexpr std::size_t simd_size = xt_simd::simd_traits<R>::size;
+            auto lhs = xt_simd::set_simd<R, R>(value);
+            std::size_t i = 0;
+            for (; i + simd_size <= size; i += simd_size)
+            {
+                auto rhs = xt_simd::load_simd<R, R>(out + i, xt_simd::unaligned_mode());
+                xt_simd::store_simd<R, R>(out + i, acc.simd_apply(lhs, rhs), xt_simd::unaligned_mode());
+            }
+            accumulate_value(acc, value, out + i, size - i, std::false_type());
+        }
+
+        template <class AF, class IF, class R, class V>
+        inline void scan_line(AF& acc, IF& init, const V* in, R* out, std::size_t size)
         {
-            // this function is the equivalent (but hopefully faster) to (if axis == 1)
-            // e[:, 0, :, :, ...] = f(e[:, 0, :, :, ...])
-            // so that all "first" values are initialized in a first pass
+            out[0] = static_cast<R>(init(in[0]));
+            for (std::size_t i = 1; i < size; ++i)
+            {
+                out[i] = static_cast<R>(acc(out[i - 1], in[i]));
+            }
+        }
 
-            std::size_t outer_loop_size, inner_loop_size, pos = 0;
-            std::size_t outer_stride, inner_stride;
+        template <class F>
+        using is_identity_accumulator = std::is_same<std::decay_t<typename F::init_functor_type>,
+                                                     accumulator_identity<typename F::init_value_type>>;
 
-            auto set_loop_sizes = [&outer_loop_size, &inner_loop_size](auto first, auto last, std::ptrdiff_t ax) {
-                outer_loop_size = std::accumulate(first, first + ax,
-                                                  std::size_t(1), std::multiplies<std::size_t>());
-                inner_loop_size = std::accumulate(first + ax + 1, last,
-                                                  std::size_t(1), std::multiplies<std::size_t>());
-            };
+        template <class F>
+        using allows_split_scan = xtl::conjunction<is_associative_reducer<std::decay_t<typename F::accumulate_functor_type>>,
+                                                   is_identity_accumulator<F>>;
 
-            // Note: add check that strides > 0
-            auto set_loop_strides = [&outer_stride, &inner_stride](auto first, auto last, std::ptrdiff_t ax) {
-                outer_stride = static_cast<std::size_t>(ax == 0 ? 1 : *std::min_element(first, first + ax));
-                inner_stride = static_cast<std::size_t>((ax == std::distance(first, last) - 1) ? 1 : *std::min_element(first + ax + 1, last));
-            };
+        template <class AF, class IF, class R, class V>
+        inline void scan_range(AF& acc, IF& init, const V* in, R* out, std::size_t size, std::false_type /*split*/)
+        {
+            scan_line(acc, init, in, out, size);
+        }
 
-            set_loop_sizes(e.shape().begin(), e.shape().end(), static_cast<std::ptrdiff_t>(axis));
-            set_loop_strides(e.strides().begin(), e.strides().end(), static_cast<std::ptrdiff_t>(axis));
+        /**
+         * Scans a long range in three phases when the execution policy is
+         * parallel: the blocks of grain size elements are scanned
+         * independently, then the running totals of the blocks are
+         * accumulated, and finally each block but the first is combined
+         * with the total of the previous ones. The blocks do not depend on
+         * the number of threads.
+         */
+        template <class AF, class IF, class R, class V>
+        inline void scan_range(AF& acc, IF& init, const V* in, R* out, std::size_t size, std::true_type /*split*/)
+        {
+            const execution::execution_policy& policy = execution::default_policy();
+            const std::size_t block_size = policy.grain_size();
+            if (!policy.is_parallel() || size < 2 * block_size)
+            {
+                scan_line(acc, init, in, out, size);
+                return;
+            }
 
-            if (e.layout() == layout_type::column_major)
+            const std::size_t nb_blocks = (size + block_size - 1) / block_size;
+            execution::parallel_for(policy.with_grain_size(1), 0, nb_blocks,
+                                    [&](std::size_t first, std::size_t last)
             {
-                // swap for better memory locality (smaller stride in the inner loop)
-                std::swap(outer_loop_size, inner_loop_size);
-                std::swap(outer_stride, inner_stride);
+                for (std::size_t b = first; b < last; ++b)
+                {
+                    std::size_t offset = b * block_size;
+                    scan_line(acc, init, in + offset, out + offset, (std::min)(block_size, size - offset));
+                }
+            });
+
+            uvector<R> carry(nb_blocks);
+            carry[1] = out[block_size - 1];
+            for (std::size_t b = 2; b < nb_blocks; ++b)
+            {
+                carry[b] = static_cast<R>(acc(carry[b - 1], out[b * block_size - 1]));
             }
 
-            for (std::size_t i = 0; i < outer_loop_size; ++i)
+            execution::parallel_for(policy.with_grain_size(1), 1, nb_blocks,
+                                    [&](std::size_t first, std::size_t last)
             {
-                pos = i * outer_stride;
-                for (std::size_t j = 0; j < inner_loop_size; ++j)
+                for (std::size_t b = first; b < last; ++b)
                 {
-                    e.storage()[pos] = f(e.storage()[pos]);
-                    pos += inner_stride;
+                    std::size_t offset = b * block_size;
+                    accumulate_value(acc, carry[b], out + offset, (std::min)(block_size, size - offset),
+                                     use_simd_accumulation<AF, R, R>());
                 }
+            });
+        }
+
+        /**
+         * Accumulates the dense data in along an axis into out, both being
+         * stored in the layout of out. The data is split in blocks of
+         * axis_size rows of nb_lanes contiguous elements: the first row of a
+         * block is initialized, and each following row is accumulated with
+         * the previous one, which is vectorized across the lanes. Blocks and
+         * groups of lanes are distributed over the threads of the current
+         * execution policy.
+         */
+        template <class F, class R, class V>
+        inline void accumulate_axis(F& f, const V* in, R* out, std::size_t size, std::size_t axis_size, std::size_t nb_lanes)
+        {
+            auto& acc = xt::get<0>(f);
+            auto& init = xt::get<1>(f);
+            using accumulate_functor_type = std::decay_t<decltype(acc)>;
+            using simd = use_simd_accumulation<accumulate_functor_type, R, V>;
+
+            const std::size_t block_size = axis_size * nb_lanes;
+            const std::size_t nb_blocks = size / block_size;
+            if (nb_lanes == 1 && nb_blocks == 1)
+            {
+                scan_range(acc, init, in, out, size, allows_split_scan<std::decay_t<F>>());
+                return;
             }
+
+            const execution::execution_policy& policy = execution::default_policy();
+            const std::size_t grain = policy.grain_size();
+            const std::size_t lanes_per_task = (std::min)(nb_lanes, (std::max)(grain / axis_size, std::size_t(1)));
+            const std::size_t tasks_per_block = (nb_lanes + lanes_per_task - 1) / lanes_per_task;
+            const std::size_t task_grain = (std::max)(grain / (axis_size * lanes_per_task), std::size_t(1));
+            execution::parallel_for(policy.with_grain_size(task_grain), 0, nb_blocks * tasks_per_block,
+                                    [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t task = first; task < last; ++task)
+                {
+                    std::size_t lane = (task % tasks_per_block) * lanes_per_task;
+                    std::size_t nb = (std::min)(lanes_per_task, nb_lanes - lane);
+                    std::size_t offset = (task / tasks_per_block) * block_size + lane;
+                    for (std::size_t l = 0; l < nb; ++l)
+                    {
+                        out[offset + l] = static_cast<R>(init(in[offset + l]));
+                    }
+                    for (std::size_t row = 1; row < axis_size; ++row)
+                    {
+                        std::size_t pos = offset + row * nb_lanes;
+                        accumulate_row(acc, out + pos - nb_lanes, in + pos, out + pos, nb, simd());
+                    }
+                }
+            });
+        }
+
+        template <class R, class E>
+        inline bool accumulate_from_data(const E&, layout_type, std::false_type /*dense*/)
+        {
+            return false;
+        }
+
+        template <class R, class E>
+        inline bool accumulate_from_data(const E& e, layout_type result_layout, std::true_type /*dense*/)
+        {
+            return std::is_same<typename E::value_type, R>::value && e.is_contiguous() &&
+                   (e.layout() == result_layout || e.dimension() <= 1);
+        }
+
+        template <class E>
+        inline auto accumulate_data(const E&, std::false_type /*dense*/)
+        {
+            using value_type = typename E::value_type;
+            return static_cast<const value_type*>(nullptr);
+        }
+
+        template <class E>
+        inline auto accumulate_data(const E& e, std::true_type /*dense*/)
+        {
+            return e.data() + e.data_offset();
         }
 
         template <class F, class E>
@@ -205,63 +385,36 @@ namespace xt
             using return_type = std::decay_t<decltype(std::declval<accumulate_functor_type>()(std::declval<init_type>(),
                                                                                               std::declval<expr_value_type>()))>;
             using result_type = xaccumulator_return_type_t<std::decay_t<E>, return_type>;
+            using dense = has_dense_values<std::decay_t<E>>;
 
             if (axis >= e.dimension())
             {
                 XTENSOR_THROW(std::runtime_error, "Axis larger than expression dimension in accumulator.");
             }
 
-            result_type result = e;  // assign + make a copy, we need it anyways
+            // the copy of the expression is fused with the accumulation when
+            // its elements can be read in the layout of the result
+            bool from_data = accumulate_from_data<return_type>(e, result_type::static_layout, dense());
+            result_type result = from_data ? result_type::from_shape(e.shape()) : result_type(e);
 
-            if(result.shape(axis) != std::size_t(0))
+            const std::size_t size = result.size();
+            const std::size_t axis_size = result.shape()[axis];
+            if (size != std::size_t(0))
             {
-                std::size_t inner_stride = static_cast<std::size_t>(result.strides()[axis]);
-                std::size_t outer_stride = 1;  // this is either going row- or column-wise (strides.back / strides.front)
-                std::size_t outer_loop_size = 0;
-                std::size_t inner_loop_size = 0;
-                std::size_t init_size = e.shape()[axis] != std::size_t(1) ? std::size_t(1) : std::size_t(0);
-
-                auto set_loop_sizes = [&outer_loop_size, &inner_loop_size, init_size](auto first, auto last, std::ptrdiff_t ax) {
-                    outer_loop_size = std::accumulate(first,
-                                                      first + ax,
-                                                      init_size, std::multiplies<std::size_t>());
-
-                    inner_loop_size = std::accumulate(first + ax,
-                                                      last,
-                                                      std::size_t(1), std::multiplies<std::size_t>());
-                };
-
-                if (result_type::static_layout == layout_type::row_major)
+                // number of lanes of a row along the axis
+                std::size_t nb_lanes = 1;
+                for (std::size_t i = 0; i < result.dimension(); ++i)
                 {
-                    set_loop_sizes(result.shape().cbegin(), result.shape().cend(), static_cast<std::ptrdiff_t>(axis));
+                    bool inner = result_type::static_layout == layout_type::row_major ? i > axis : i < axis;
+                    nb_lanes *= inner ? result.shape()[i] : std::size_t(1);
                 }
-                else
+                if (from_data)
                 {
-                    set_loop_sizes(result.shape().cbegin(), result.shape().cend(), static_cast<std::ptrdiff_t>(axis + 1));
-                    std::swap(inner_loop_size, outer_loop_size);
+                    accumulate_axis(f, accumulate_data(e, dense()), result.data(), size, axis_size, nb_lanes);
                 }
-
-                std::size_t pos = 0;
-
-                inner_loop_size = inner_loop_size - inner_stride;
-
-                // activate the init loop if we have an init function other than identity
-                if (!std::is_same<std::decay_t<typename F::init_functor_type>,
-                                  typename detail::accumulator_identity<init_type>>::value)
-                {
-                    accumulator_init_with_f(xt::get<1>(f), result, axis);
-                }
-
-                pos = 0;
-                for (std::size_t i = 0; i < outer_loop_size; ++i)
+                else
                 {
-                    for (std::size_t j = 0; j < inner_loop_size; ++j)
-                    {
-                        result.storage()[pos + inner_stride] = xt::get<0>(f)(result.storage()[pos],
-                                                                             result.storage()[pos + inner_stride]);
-                        pos += outer_stride;
-                    }
-                    pos += inner_stride;
+                    accumulate_axis(f, result.data(), result.data(), size, axis_size, nb_lanes);
                 }
             }
             return result;
@@ -277,24 +430,115 @@ namespace xt
                                                                                               std::declval<expr_value_type>()))>;
             //using return_type = std::conditional_t<std::is_same<init_type, void>::value, typename std::decay_t<E>::value_type, init_type>;
             using result_type = xaccumulator_return_type_t<std::decay_t<E>, return_type>;
+            using dense = has_dense_values<std::decay_t<E>>;
 
             std::size_t sz = e.size();
             auto result = result_type::from_shape({sz});
+            if (sz == std::size_t(0))
+            {
+                return result;
+            }
 
-            if(sz != std::size_t(0))
+            auto& acc = xt::get<0>(f);
+            auto& init = xt::get<1>(f);
+            auto* out = result.data();
+            if (accumulate_from_data<expr_value_type>(e, XTENSOR_DEFAULT_TRAVERSAL, dense()))
+            {
+                scan_range(acc, init, accumulate_data(e, dense()), out, sz, allows_split_scan<std::decay_t<F>>());
+            }
+            else if (std::is_same<expr_value_type, return_type>::value)
+            {
+                std::copy(e.template begin<XTENSOR_DEFAULT_TRAVERSAL>(), e.template end<XTENSOR_DEFAULT_TRAVERSAL>(), out);
+                scan_range(acc, init, out, out, sz, allows_split_scan<std::decay_t<F>>());
+            }
+            else
             {
                 auto it = e.template begin<XTENSOR_DEFAULT_TRAVERSAL>();
-                result.storage()[0] = xt::get<1>(f)(*it);
+                out[0] = static_cast<return_type>(init(*it));
                 ++it;
 
                 for (std::size_t idx = 0; it != e.template end<XTENSOR_DEFAULT_TRAVERSAL>(); ++it)
                 {
-                    result.storage()[idx + 1] = xt::get<0>(f)(result.storage()[idx], *it);
+                    out[idx + 1] = static_cast<return_type>(acc(out[idx], *it));
                     ++idx;
                 }
             }
             return result;
         }
+
+        /**
+         * Cumulative sum along an axis using compensated (Kahan) summation.
+         * Each lane of the axis carries its running sum and compensation, so
+         * that the accumulated error does not grow with the length of the axis.
+         */
+        template <class T, class E>
+        inline auto compensated_cumsum(E&& e, std::size_t axis)
+        {
+            using expr_value_type = typename std::decay_t<E>::value_type;
+            using return_type = std::decay_t<decltype(std::declval<T>() + std::declval<expr_value_type>())>;
+            using result_type = xaccumulator_return_type_t<std::decay_t<E>, return_type>;
+
+            if (axis >= e.dimension())
+            {
+                XTENSOR_THROW(std::runtime_error, "Axis larger than expression dimension in accumulator.");
+            }
+
+            result_type result = e;
+            std::size_t axis_size = result.shape()[axis];
+            if (axis_size < std::size_t(2))
+            {
+                return result;
+            }
+
+            // the result is contiguous: the axis splits it in blocks of axis_size * nb_lanes
+            // elements, each row of a block holding nb_lanes independent sums.
+            std::size_t nb_lanes = static_cast<std::size_t>(result.strides()[axis]);
+            std::size_t block_size = axis_size * nb_lanes;
+            uvector<return_type> sum(nb_lanes);
+            uvector<return_type> compensation(nb_lanes);
+            auto* data = result.data();
+            for (std::size_t block = 0; block < result.size(); block += block_size)
+            {
+                std::copy(data + block, data + block + nb_lanes, sum.begin());
+                std::fill(compensation.begin(), compensation.end(), return_type(0));
+                for (std::size_t row = block + nb_lanes; row < block + block_size; row += nb_lanes)
+                {
+                    for (std::size_t l = 0; l < nb_lanes; ++l)
+                    {
+                        return_type y = data[row + l] - compensation[l];
+                        return_type t = sum[l] + y;
+                        compensation[l] = (t - sum[l]) - y;
+                        sum[l] = t;
+                        data[row + l] = t - compensation[l];
+                    }
+                }
+            }
+            return result;
+        }
+
+        template <class T, class E>
+        inline auto compensated_cumsum(E&& e)
+        {
+            using expr_value_type = typename std::decay_t<E>::value_type;
+            using return_type = std::decay_t<decltype(std::declval<T>() + std::declval<expr_value_type>())>;
+            using result_type = xaccumulator_return_type_t<std::decay_t<E>, return_type>;
+
+            std::size_t sz = e.size();
+            auto result = result_type::from_shape({sz});
+
+            return_type sum = return_type(0);
+            return_type compensation = return_type(0);
+            std::size_t idx = 0;
+            for (auto it = e.template begin<XTENSOR_DEFAULT_TRAVERSAL>(); it != e.template end<XTENSOR_DEFAULT_TRAVERSAL>(); ++it, ++idx)
+            {
+                return_type y = static_cast<return_type>(*it) - compensation;
+                return_type t = sum + y;
+                compensation = (t - sum) - y;
+                sum = t;
+                result.storage()[idx] = sum - compensation;
+            }
+            return result;
+        }
     }
 
     /**
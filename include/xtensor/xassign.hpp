@@ -18,6 +18,7 @@
 #include <xtl/xcomplex.hpp>
 #include <xtl/xsequence.hpp>
 
+#include "xexecution.hpp"
 #include "xexpression.hpp"
 #include "xiterator.hpp"
 #include "xstrides.hpp"
@@ -26,10 +27,6 @@
 #include "xutils.hpp"
 #include "xfunction.hpp"
 
-#if defined(XTENSOR_USE_TBB)
-#include <tbb/tbb.h>
-#endif
-
 namespace xt
 {
 
@@ -40,6 +37,10 @@ namespace xt
     template <class E1, class E2>
     void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial);
 
+    template <class E1, class E2>
+    void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial,
+                     const execution::execution_policy& policy);
+
     template <class E1, class E2>
     void assign_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2);
 
@@ -193,6 +194,18 @@ namespace xt
         xexpression_assigner<tag>::assign_data(e1, e2, trivial);
     }
 
+    /**
+     * Assigns e2 to e1 with the given execution policy instead of the
+     * default policy of the current thread.
+     */
+    template <class E1, class E2>
+    inline void assign_data(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial,
+                            const execution::execution_policy& policy)
+    {
+        execution::scoped_policy guard(policy);
+        assign_data(e1, e2, trivial);
+    }
+
     template <class E1, class E2>
     inline void assign_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2)
     {
@@ -640,42 +653,19 @@ namespace xt
             e1.data_element(i) = conditional_cast<needs_cast, e1_value_type>(e2.data_element(i));
         }
 
-#if defined(XTENSOR_USE_TBB)
-        tbb::parallel_for(align_begin, align_end, simd_size, [&e1, &e2](size_t i)
+        // Chunks are expressed in number of batches so that their bounds stay aligned
+        const execution::execution_policy& policy = execution::default_policy();
+        size_type nb_batches = (align_end - align_begin) / simd_size;
+        size_type grain = (std::max)(policy.grain_size() / simd_size, size_type(1));
+        execution::parallel_for(policy.with_grain_size(grain), size_type(0), nb_batches,
+                                [&e1, &e2, align_begin](size_type first, size_type last)
         {
-            e1.template store_simd<lhs_align_mode>(i, e2.template load_simd<rhs_align_mode, value_type>(i));
-        });
-#elif defined(XTENSOR_USE_OPENMP)
-        if (size >= XTENSOR_OPENMP_TRESHOLD)
-        {
-            #pragma omp parallel for default(none) shared(align_begin, align_end, e1, e2)
-    #ifndef _WIN32
-            for (size_type i = align_begin; i < align_end; i += simd_size)
+            size_type chunk_end = align_begin + last * simd_size;
+            for (size_type i = align_begin + first * simd_size; i < chunk_end; i += simd_size)
             {
                 e1.template store_simd<lhs_align_mode>(i, e2.template load_simd<rhs_align_mode, value_type>(i));
             }
-    #else
-            for(auto i = static_cast<std::ptrdiff_t>(align_begin); i < static_cast<std::ptrdiff_t>(align_end);
-                i += static_cast<std::ptrdiff_t>(simd_size))
-            {
-                size_type ui = static_cast<size_type>(i);
-                e1.template store_simd<lhs_align_mode>(ui, e2.template load_simd<rhs_align_mode, value_type>(ui));
-            }
-    #endif
-        }
-        else
-        {
-            for (size_type i = align_begin; i < align_end; i += simd_size)
-            {
-                e1.template store_simd<lhs_align_mode>(i, e2.template load_simd<rhs_align_mode, value_type>(i));
-            }
-        }
-#else
-        for (size_type i = align_begin; i < align_end; i += simd_size)
-        {
-            e1.template store_simd<lhs_align_mode>(i, e2.template load_simd<rhs_align_mode, value_type>(i));
-        }
-#endif
+        });
         for (size_type i = align_end; i < size; ++i)
         {
             e1.data_element(i) = conditional_cast<needs_cast, e1_value_type>(e2.data_element(i));
@@ -702,25 +692,17 @@ namespace xt
         auto dst = linear_begin(e1);
         size_type n = e1.size();
 
-#if defined(XTENSOR_USE_TBB)
-        tbb::parallel_for(std::ptrdiff_t(0), static_cast<std::ptrdiff_t>(n), [&](std::ptrdiff_t i)
+        execution::parallel_for(execution::default_policy(), size_type(0), n, [&src, &dst](size_type first, size_type last)
         {
-            *(dst + i) = static_cast<value_type>(*(src + i));
+            auto chunk_src = src + static_cast<std::ptrdiff_t>(first);
+            auto chunk_dst = dst + static_cast<std::ptrdiff_t>(first);
+            for (size_type i = last - first; i > size_type(0); --i)
+            {
+                *chunk_dst = static_cast<value_type>(*chunk_src);
+                ++chunk_src;
+                ++chunk_dst;
+            }
         });
-#elif defined(XTENSOR_USE_OPENMP)
-        #pragma omp parallel for default(none) shared(src, dst, n)
-        for (std::ptrdiff_t i = std::ptrdiff_t(0); i < static_cast<std::ptrdiff_t>(n) ; i++)
-        {
-            *(dst + i) = static_cast<value_type>(*(src + i));
-        }
-#else
-        for (; n > size_type(0); --n)
-        {
-            *dst = static_cast<value_type>(*src);
-            ++src;
-            ++dst;
-        }
-#endif
     }
 
     template <class E1, class E2>
@@ -760,6 +742,16 @@ namespace xt
                     }
                 }
             }
+
+            template <class T>
+            static void nth_idx(std::size_t n, T& outer_index, const T& outer_shape)
+            {
+                for (auto i = outer_index.size(); i > 0; --i)
+                {
+                    outer_index[i - 1] = n % outer_shape[i - 1];
+                    n /= outer_shape[i - 1];
+                }
+            }
         };
 
         template <>
@@ -784,6 +776,17 @@ namespace xt
                     }
                 }
             }
+
+            template <class T>
+            static void nth_idx(std::size_t n, T& outer_index, const T& outer_shape)
+            {
+                auto sz = outer_index.size();
+                for (std::size_t i = 0; i < sz; ++i)
+                {
+                    outer_index[i] = n % outer_shape[i];
+                    n /= outer_shape[i];
+                }
+            }
         };
 
         template <layout_type L, class S>
@@ -918,21 +921,17 @@ namespace xt
         }
 
         // TODO can we get rid of this and use `shape_type`?
-        dynamic_shape<std::size_t> idx, max_shape;
+        dynamic_shape<std::size_t> max_shape;
 
         if (is_row_major)
         {
-            xt::resize_container(idx, cut);
             max_shape.assign(e1.shape().begin(), e1.shape().begin() + static_cast<std::ptrdiff_t>(cut));
         }
         else
         {
-            xt::resize_container(idx, e1.shape().size() - cut);
             max_shape.assign(e1.shape().begin() + static_cast<std::ptrdiff_t>(cut), e1.shape().end());
         }
 
-        // add this when we have std::array index!
-        // std::fill(idx.begin(), idx.end(), 0);
         using e1_value_type = typename E1::value_type;
         using e2_value_type = typename E2::value_type;
         constexpr bool needs_cast = has_assign_conversion<e1_value_type, e2_value_type>::value;
@@ -944,9 +943,6 @@ namespace xt
         std::size_t simd_size = inner_loop_size / simd_type::size;
         std::size_t simd_rest = inner_loop_size % simd_type::size;
 
-        auto fct_stepper = e2.stepper_begin(e1.shape());
-        auto res_stepper = e1.stepper_begin(e1.shape());
-
         // TODO in 1D case this is ambigous -- could be RM or CM.
         //      Use default layout to make decision
         std::size_t step_dim = 0;
@@ -955,43 +951,69 @@ namespace xt
             step_dim = cut;
         }
 
-        for (std::size_t ox = 0; ox < outer_loop_size; ++ox)
+        // Each call processes the outer indices [first, last) with its own pair
+        // of steppers, so that the outer loop can be split across threads.
+        auto run_outer_range = [&](std::size_t first, std::size_t last)
         {
-            for (std::size_t i = 0; i < simd_size; ++i)
+            dynamic_shape<std::size_t> idx;
+            xt::resize_container(idx, max_shape.size());
+            is_row_major ?
+                strided_assign_detail::idx_tools<layout_type::row_major>::nth_idx(first, idx, max_shape) :
+                strided_assign_detail::idx_tools<layout_type::column_major>::nth_idx(first, idx, max_shape);
+
+            auto fct_stepper = e2.stepper_begin(e1.shape());
+            auto res_stepper = e1.stepper_begin(e1.shape());
+
+            for (std::size_t i = 0; i < idx.size(); ++i)
             {
-                res_stepper.store_simd(fct_stepper.template step_simd<value_type>());
+                fct_stepper.step(i + step_dim, idx[i]);
+                res_stepper.step(i + step_dim, idx[i]);
             }
-            for (std::size_t i = 0; i < simd_rest; ++i)
+
+            for (std::size_t ox = first; ox < last; ++ox)
             {
-                *(res_stepper) = conditional_cast<needs_cast, e1_value_type>(*(fct_stepper));
-                res_stepper.step_leading();
-                fct_stepper.step_leading();
-            }
+                for (std::size_t i = 0; i < simd_size; ++i)
+                {
+                    res_stepper.store_simd(fct_stepper.template step_simd<value_type>());
+                }
+                for (std::size_t i = 0; i < simd_rest; ++i)
+                {
+                    *(res_stepper) = conditional_cast<needs_cast, e1_value_type>(*(fct_stepper));
+                    res_stepper.step_leading();
+                    fct_stepper.step_leading();
+                }
 
-            is_row_major ?
-                strided_assign_detail::idx_tools<layout_type::row_major>::next_idx(idx, max_shape) :
-                strided_assign_detail::idx_tools<layout_type::column_major>::next_idx(idx, max_shape);
+                is_row_major ?
+                    strided_assign_detail::idx_tools<layout_type::row_major>::next_idx(idx, max_shape) :
+                    strided_assign_detail::idx_tools<layout_type::column_major>::next_idx(idx, max_shape);
 
-            fct_stepper.to_begin();
+                fct_stepper.to_begin();
 
-            // need to step E1 as well if not contigous assign (e.g. view)
-            if (!E1::contiguous_layout)
-            {
-                res_stepper.to_begin();
-                for (std::size_t i = 0; i < idx.size(); ++i)
+                // need to step E1 as well if not contigous assign (e.g. view)
+                if (!E1::contiguous_layout)
                 {
-                    fct_stepper.step(i + step_dim, idx[i]);
-                    res_stepper.step(i + step_dim, idx[i]);
+                    res_stepper.to_begin();
+                    for (std::size_t i = 0; i < idx.size(); ++i)
+                    {
+                        fct_stepper.step(i + step_dim, idx[i]);
+                        res_stepper.step(i + step_dim, idx[i]);
+                    }
                 }
-            }
-            else
-            {
-                for (std::size_t i = 0; i < idx.size(); ++i)
+                else
                 {
-                    fct_stepper.step(i + step_dim, idx[i]);
+                    for (std::size_t i = 0; i < idx.size(); ++i)
+                    {
+                        fct_stepper.step(i + step_dim, idx[i]);
+                    }
                 }
             }
-        }
+        };
+
+        // The grain size of the policy is expressed in elements, each outer
+        // index accounts for inner_loop_size of them.
+        const execution::execution_policy& policy = execution::default_policy();
+        std::size_t grain = (std::max)(policy.grain_size() / (std::max)(inner_loop_size, std::size_t(1)), std::size_t(1));
+        execution::parallel_for(policy.with_grain_size(grain), 0, outer_loop_size, run_outer_range);
     }
 
     template <>
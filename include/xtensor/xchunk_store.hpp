@@ -0,0 +1,1082 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_CHUNK_STORE_HPP
+#define XTENSOR_CHUNK_STORE_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <fstream>
+#include <future>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+#include "xarray.hpp"
+#include "xbroadcast.hpp"
+#include "xchunked_array.hpp"
+#include "xexception.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+
+    /*************************
+     * xchunk_store_iterator *
+     *************************/
+
+    /**
+     * @class xchunk_store_iterator
+     * @brief Iterator over the chunks of a chunk store, in the row-major
+     * order of the grid of chunks.
+     *
+     * Dereferencing the iterator loads the chunk in the pool of the store
+     * and pins it there until the iterator is incremented, dereferenced
+     * again or destroyed.
+     *
+     * @tparam S the chunk store type, possibly const
+     */
+    template <class S>
+    class xchunk_store_iterator
+    {
+    public:
+
+        using self_type = xchunk_store_iterator<S>;
+        using store_type = std::remove_const_t<S>;
+        using value_type = typename store_type::value_type;
+        using reference = std::conditional_t<std::is_const<S>::value, const value_type&, value_type&>;
+        using pointer = std::conditional_t<std::is_const<S>::value, const value_type*, value_type*>;
+        using size_type = typename store_type::size_type;
+        using difference_type = typename store_type::difference_type;
+        using iterator_category = std::forward_iterator_tag;
+
+        xchunk_store_iterator() = default;
+        xchunk_store_iterator(S& store, size_type index);
+
+        self_type& operator++();
+        self_type operator++(int);
+        self_type operator+(difference_type n) const;
+
+        reference operator*() const;
+        pointer operator->() const;
+
+        bool operator==(const self_type& rhs) const;
+        bool operator!=(const self_type& rhs) const;
+
+    private:
+
+        using pinned_chunk = std::conditional_t<std::is_const<S>::value,
+                                                typename store_type::const_pinned_chunk,
+                                                typename store_type::pinned_chunk>;
+
+        S* p_store = nullptr;
+        size_type m_index = 0;
+        mutable pinned_chunk m_chunk;
+    };
+
+    /**************
+     * xraw_codec *
+     **************/
+
+    /**
+     * @class xraw_codec
+     * @brief Codec storing the bytes of the chunks without compression.
+     *
+     * A codec encodes the bytes of a chunk to the stream of its file and
+     * decodes them back; it is used concurrently from several threads through
+     * its const methods. Its id is the identifier of the compressor in the
+     * metadata of a Zarr array, empty for uncompressed chunks, and its config
+     * is the JSON object describing the compressor in these metadata.
+     *
+     * @sa xchunk_file_store, load_zarr, dump_zarr
+     */
+    class xraw_codec
+    {
+    public:
+
+        std::string id() const;
+        std::string config() const;
+
+        void encode(const char* data, std::size_t size, std::ostream& stream) const;
+        bool decode(std::istream& stream, char* data, std::size_t size) const;
+    };
+
+    /*********************
+     * xchunk_file_store *
+     *********************/
+
+    /**
+     * @class xchunk_file_store
+     * @brief Chunk storage keeping each chunk in a file of a local directory.
+     *
+     * Chunks are loaded on access in a pool of at most pool_size chunks. When
+     * the pool is full, the least recently used chunk is evicted and written
+     * back to its file if it was accessed through a non-const method. Chunks
+     * whose file does not exist yet are filled with the fill value. Each chunk
+     * is stored as the raw bytes of a whole chunk in the memory layout L, in a
+     * file named after the index of the chunk in the grid, the components
+     * being separated with dots (e.g. ``1.0.2``).
+     *
+     * The bytes of the chunks are encoded in their files with the codec C.
+     *
+     * When prefetching is enabled, loading a chunk from its file starts
+     * loading the next chunk of the grid on a background thread.
+     *
+     * The chunks are returned pinned in the pool: a chunk is not evicted
+     * while a pointer returned by the store is alive, the pool temporarily
+     * holding more than pool_size chunks when all of them are pinned. The
+     * elements of a file-backed chunked array are returned by value, or
+     * through references that pin their chunk. Since loading a chunk stalls
+     * the other threads accessing the pool, the chunks of file-backed arrays,
+     * and of expressions reading from them, are assigned one after the other.
+     *
+     * @tparam T the value type of the elements, which must be trivially copyable
+     * @tparam L the memory layout of the chunks
+     * @tparam C the codec of the chunk files
+     * @sa chunked_file_array, xraw_codec
+     */
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class C = xraw_codec>
+    class xchunk_file_store
+    {
+    public:
+
+        static_assert(std::is_trivially_copyable<T>::value, "xchunk_file_store requires trivially copyable elements");
+
+        using self_type = xchunk_file_store<T, L, C>;
+        using value_type = xarray<T, L>;
+        using pinned_chunk = std::shared_ptr<value_type>;
+        using const_pinned_chunk = std::shared_ptr<const value_type>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using shape_type = std::vector<size_type>;
+        using chunk_shape_type = typename value_type::shape_type;
+        using codec_type = C;
+        using iterator = xchunk_store_iterator<self_type>;
+        using const_iterator = xchunk_store_iterator<const self_type>;
+
+        template <class S>
+        xchunk_file_store(const std::string& directory, S&& chunk_shape,
+                          size_type pool_size = 1, bool prefetch = false, const T& fill_value = T(),
+                          const codec_type& codec = codec_type());
+        ~xchunk_file_store();
+
+        xchunk_file_store(const xchunk_file_store&) = delete;
+        xchunk_file_store& operator=(const xchunk_file_store&) = delete;
+
+        xchunk_file_store(xchunk_file_store&&) = default;
+        xchunk_file_store& operator=(xchunk_file_store&&) = default;
+
+        size_type dimension() const noexcept;
+        const shape_type& shape() const noexcept;
+        size_type size() const noexcept;
+        const chunk_shape_type& chunk_shape() const noexcept;
+
+        const std::string& directory() const noexcept;
+        size_type pool_size() const noexcept;
+        const T& fill_value() const noexcept;
+        const codec_type& codec() const noexcept;
+        std::string chunk_path(size_type index) const;
+
+        template <class S>
+        void resize(S&& shape);
+
+        template <class It>
+        pinned_chunk element(It first, It last);
+        template <class It>
+        const_pinned_chunk element(It first, It last) const;
+
+        pinned_chunk flat(size_type index);
+        const_pinned_chunk flat(size_type index) const;
+
+        iterator begin();
+        iterator end();
+        const_iterator begin() const;
+        const_iterator end() const;
+        const_iterator cbegin() const;
+        const_iterator cend() const;
+
+        void flush();
+
+    private:
+
+        static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+        struct pool_slot
+        {
+            pinned_chunk chunk;
+            size_type index = npos;
+            size_type last_use = 0;
+            bool dirty = false;
+        };
+
+        struct pool_state
+        {
+            std::mutex mutex;
+            std::vector<pool_slot> slots;
+            std::vector<size_type> slot_of;
+            size_type clock = 0;
+            size_type prefetched = npos;
+            std::future<value_type> prefetch;
+        };
+
+        template <class It>
+        size_type linear_index(It first, It last) const;
+
+        pinned_chunk fetch(size_type index, bool dirty) const;
+        size_type evict(pool_state& state) const;
+        void write_back(pool_slot& slot) const;
+
+        static value_type load_chunk(const std::string& path, const chunk_shape_type& chunk_shape,
+                                     const T& fill_value, const codec_type& codec);
+
+        std::string m_directory;
+        chunk_shape_type m_chunk_shape;
+        shape_type m_shape;
+        size_type m_size;
+        size_type m_pool_size;
+        bool m_prefetch;
+        T m_fill_value;
+        codec_type m_codec;
+        std::unique_ptr<pool_state> p_state;
+    };
+
+    /********************
+     * xchunk_reference *
+     ********************/
+
+    /**
+     * @class xchunk_reference
+     * @brief Reference to an element of a chunk of a file-backed chunked
+     * array, keeping the chunk pinned in the pool of its store.
+     *
+     * @tparam CH the chunk type
+     */
+    template <class CH>
+    class xchunk_reference
+    {
+    public:
+
+        using chunk_type = CH;
+        using value_type = typename chunk_type::value_type;
+        using pinned_chunk = std::shared_ptr<chunk_type>;
+
+        xchunk_reference(pinned_chunk chunk, value_type& element) noexcept;
+
+        xchunk_reference(const xchunk_reference&) = default;
+        xchunk_reference& operator=(const xchunk_reference& rhs);
+
+        template <class V>
+        xchunk_reference& operator=(const V& v);
+
+        template <class V>
+        xchunk_reference& operator+=(const V& v);
+        template <class V>
+        xchunk_reference& operator-=(const V& v);
+        template <class V>
+        xchunk_reference& operator*=(const V& v);
+        template <class V>
+        xchunk_reference& operator/=(const V& v);
+
+        operator value_type() const noexcept;
+
+    private:
+
+        pinned_chunk m_chunk;
+        value_type* p_element;
+    };
+
+    namespace detail
+    {
+        template <class T, layout_type L, class C>
+        struct allows_parallel_chunk_assign<xchunked_array<xchunk_file_store<T, L, C>>> : std::false_type
+        {
+        };
+
+        /**
+         * The elements of a file-backed chunked array are returned by value
+         * or through references pinning their chunk, since a reference to the
+         * element of a chunk would not survive its eviction from the pool.
+         */
+        template <class T, layout_type L, class C>
+        struct xchunked_array_access<xchunk_file_store<T, L, C>>
+        {
+            using store_type = xchunk_file_store<T, L, C>;
+            using chunk_type = typename store_type::value_type;
+            using const_reference = T;
+            using reference = xchunk_reference<chunk_type>;
+
+            template <class It>
+            static reference element(const typename store_type::pinned_chunk& chunk, It first, It last)
+            {
+                return reference(chunk, chunk->element(first, last));
+            }
+
+            template <class It>
+            static const_reference element(const typename store_type::const_pinned_chunk& chunk, It first, It last)
+            {
+                return chunk->element(first, last);
+            }
+        };
+
+        /**
+         * The chunk iterators of file-backed chunked arrays keep the chunk
+         * they were dereferenced to pinned in the pool.
+         */
+        template <class A>
+        struct xchunk_iterator_file_array
+        {
+            using store_type = typename std::remove_const_t<A>::chunk_storage_type;
+            using pinned_chunk = std::conditional_t<std::is_const<A>::value,
+                                                    typename store_type::const_pinned_chunk,
+                                                    typename store_type::pinned_chunk>;
+            using reference = decltype(*std::declval<pinned_chunk>());
+
+            inline reference get_chunk(A& arr, typename A::size_type i, const xstrided_slice_vector&) const
+            {
+                m_chunk.reset();
+                m_chunk = arr.chunks().flat(i);
+                return *m_chunk;
+            }
+
+            mutable pinned_chunk m_chunk;
+        };
+
+        template <class T, layout_type L, class C>
+        struct xchunk_iterator_array<xchunked_array<xchunk_file_store<T, L, C>>>
+            : xchunk_iterator_file_array<xchunked_array<xchunk_file_store<T, L, C>>>
+        {
+        };
+
+        template <class T, layout_type L, class C>
+        struct xchunk_iterator_array<const xchunked_array<xchunk_file_store<T, L, C>>>
+            : xchunk_iterator_file_array<const xchunked_array<xchunk_file_store<T, L, C>>>
+        {
+        };
+
+        inline void make_directory(const std::string& directory)
+        {
+#if defined(_WIN32)
+            int res = _mkdir(directory.c_str());
+#else
+            int res = mkdir(directory.c_str(), 0755);
+#endif
+            if (res != 0 && errno != EEXIST)
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed to create directory: " + directory);
+            }
+        }
+
+        template <class E, class = void>
+        struct has_expression_method : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_expression_method<E, void_t<decltype(std::declval<const E&>().expression())>> : std::true_type
+        {
+        };
+
+        template <class F, class... CT>
+        bool reads_array(const xfunction<F, CT...>& e, const void* arr);
+
+        template <class E>
+        bool reads_array(const E& e, const void* arr);
+
+        template <class E>
+        inline bool reads_array_impl(const E& e, const void* arr, std::false_type /*has_expression_method*/)
+        {
+            return static_cast<const void*>(&e) == arr;
+        }
+
+        template <class E>
+        inline bool reads_array_impl(const E& e, const void* arr, std::true_type /*has_expression_method*/)
+        {
+            return static_cast<const void*>(&e) == arr || reads_array(e.expression(), arr);
+        }
+
+        /**
+         * Whether the array at the address arr is an operand of e, or of the
+         * functions and views that e is built from.
+         */
+        template <class E>
+        inline bool reads_array(const E& e, const void* arr)
+        {
+            return reads_array_impl(e, arr, has_expression_method<E>());
+        }
+
+        template <class F, class... CT>
+        inline bool reads_array(const xfunction<F, CT...>& e, const void* arr)
+        {
+            bool res = false;
+            for_each([&res, arr](const auto& arg) { res = res || reads_array(arg, arr); }, e.arguments());
+            return res;
+        }
+    }
+
+    /**
+     * Assigns expressions to file-backed chunked arrays in place: the shape of
+     * such arrays is fixed, and the expression is broadcast to it. Since the
+     * chunks are overwritten one after the other, assigning an expression that
+     * reads the array throws; noalias assigns it in place, which is correct
+     * when each element only depends on the elements at the same position, as
+     * in ``noalias(a) = 2 * a``.
+     */
+    template <class T, class V, layout_type L, class C>
+    class xchunked_assigner<T, xchunk_file_store<V, L, C>>
+    {
+    public:
+
+        using temporary_type = T;
+
+        template <class E, class DST>
+        void build_and_assign_temporary(const xexpression<E>& e, DST& dst);
+    };
+
+    /**
+     * Creates a chunked array whose chunks are stored in files.
+     * The chunks are stored in the given directory, which is created if it does
+     * not exist; chunks whose file does not exist yet are filled with the fill
+     * value, so that an existing directory of chunks can be reopened.
+     *
+     * @tparam T The type of the elements (e.g. double)
+     * @tparam L The layout_type of the chunks
+     * @tparam C The codec of the chunk files
+     *
+     * @param shape The shape of the array
+     * @param chunk_shape The shape of a chunk
+     * @param directory The directory holding the chunk files
+     * @param pool_size The maximum number of chunks held in memory
+     * @param prefetch Whether the next chunk is loaded in the background
+     * @param fill_value The value of the elements of the chunks without file
+     * @param codec The codec of the chunk files
+     *
+     * @return returns a ``xchunked_array<xchunk_file_store<T, L, C>>`` with the given shape and chunk shape.
+     */
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class S, class C = xraw_codec>
+    xchunked_array<xchunk_file_store<T, L, C>>
+    chunked_file_array(S&& shape, S&& chunk_shape, const std::string& directory,
+                       std::size_t pool_size = 1, bool prefetch = false, const T& fill_value = T(),
+                       const C& codec = C());
+
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class S, class C = xraw_codec>
+    xchunked_array<xchunk_file_store<T, L, C>>
+    chunked_file_array(std::initializer_list<S> shape, std::initializer_list<S> chunk_shape, const std::string& directory,
+                       std::size_t pool_size = 1, bool prefetch = false, const T& fill_value = T(),
+                       const C& codec = C());
+
+    /*****************************
+     * xraw_codec implementation *
+     *****************************/
+
+    inline std::string xraw_codec::id() const
+    {
+        return std::string();
+    }
+
+    inline std::string xraw_codec::config() const
+    {
+        return "null";
+    }
+
+    /**
+     * Writes size bytes of data to the stream.
+     */
+    inline void xraw_codec::encode(const char* data, std::size_t size, std::ostream& stream) const
+    {
+        stream.write(data, static_cast<std::streamsize>(size));
+    }
+
+    /**
+     * Reads size bytes from the stream to data. Returns false if the stream
+     * does not hold exactly size bytes.
+     */
+    inline bool xraw_codec::decode(std::istream& stream, char* data, std::size_t size) const
+    {
+        stream.read(data, static_cast<std::streamsize>(size));
+        return stream.gcount() == static_cast<std::streamsize>(size) &&
+               stream.peek() == std::istream::traits_type::eof();
+    }
+
+    /****************************************
+     * xchunk_store_iterator implementation *
+     ****************************************/
+
+    template <class S>
+    inline xchunk_store_iterator<S>::xchunk_store_iterator(S& store, size_type index)
+        : p_store(&store), m_index(index)
+    {
+    }
+
+    template <class S>
+    inline auto xchunk_store_iterator<S>::operator++() -> self_type&
+    {
+        m_chunk.reset();
+        ++m_index;
+        return *this;
+    }
+
+    template <class S>
+    inline auto xchunk_store_iterator<S>::operator++(int) -> self_type
+    {
+        self_type tmp(*this);
+        ++m_index;
+        return tmp;
+    }
+
+    template <class S>
+    inline auto xchunk_store_iterator<S>::operator+(difference_type n) const -> self_type
+    {
+        return self_type(*p_store, static_cast<size_type>(static_cast<difference_type>(m_index) + n));
+    }
+
+    template <class S>
+    inline auto xchunk_store_iterator<S>::operator*() const -> reference
+    {
+        m_chunk.reset();
+        m_chunk = p_store->flat(m_index);
+        return *m_chunk;
+    }
+
+    template <class S>
+    inline auto xchunk_store_iterator<S>::operator->() const -> pointer
+    {
+        return &(**this);
+    }
+
+    template <class S>
+    inline bool xchunk_store_iterator<S>::operator==(const self_type& rhs) const
+    {
+        return m_index == rhs.m_index;
+    }
+
+    template <class S>
+    inline bool xchunk_store_iterator<S>::operator!=(const self_type& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    /***********************************
+     * xchunk_reference implementation *
+     ***********************************/
+
+    template <class CH>
+    inline xchunk_reference<CH>::xchunk_reference(pinned_chunk chunk, value_type& element) noexcept
+        : m_chunk(std::move(chunk)), p_element(&element)
+    {
+    }
+
+    template <class CH>
+    inline auto xchunk_reference<CH>::operator=(const xchunk_reference& rhs) -> xchunk_reference&
+    {
+        *p_element = static_cast<value_type>(rhs);
+        return *this;
+    }
+
+    template <class CH>
+    template <class V>
+    inline auto xchunk_reference<CH>::operator=(const V& v) -> xchunk_reference&
+    {
+        *p_element = static_cast<value_type>(v);
+        return *this;
+    }
+
+    template <class CH>
+    template <class V>
+    inline auto xchunk_reference<CH>::operator+=(const V& v) -> xchunk_reference&
+    {
+        *p_element += v;
+        return *this;
+    }
+
+    template <class CH>
+    template <class V>
+    inline auto xchunk_reference<CH>::operator-=(const V& v) -> xchunk_reference&
+    {
+        *p_element -= v;
+        return *this;
+    }
+
+    template <class CH>
+    template <class V>
+    inline auto xchunk_reference<CH>::operator*=(const V& v) -> xchunk_reference&
+    {
+        *p_element *= v;
+        return *this;
+    }
+
+    template <class CH>
+    template <class V>
+    inline auto xchunk_reference<CH>::operator/=(const V& v) -> xchunk_reference&
+    {
+        *p_element /= v;
+        return *this;
+    }
+
+    template <class CH>
+    inline xchunk_reference<CH>::operator value_type() const noexcept
+    {
+        return *p_element;
+    }
+
+    /************************************
+     * xchunk_file_store implementation *
+     ************************************/
+
+    template <class T, layout_type L, class C>
+    constexpr typename xchunk_file_store<T, L, C>::size_type xchunk_file_store<T, L, C>::npos;
+
+    /**
+     * Builds a store of chunks of the given shape in the given directory,
+     * which is created if it does not exist.
+     * @param directory the directory holding the chunk files
+     * @param chunk_shape the shape of a chunk
+     * @param pool_size the maximum number of chunks held in memory
+     * @param prefetch whether the next chunk is loaded in the background
+     * @param fill_value the value of the elements of the chunks without file
+     * @param codec the codec of the chunk files
+     */
+    template <class T, layout_type L, class C>
+    template <class S>
+    inline xchunk_file_store<T, L, C>::xchunk_file_store(const std::string& directory, S&& chunk_shape,
+                                                         size_type pool_size, bool prefetch, const T& fill_value,
+                                                         const codec_type& codec)
+        : m_directory(directory),
+          m_chunk_shape(xtl::forward_sequence<chunk_shape_type, S>(chunk_shape)),
+          m_shape(),
+          m_size(0),
+          m_pool_size(pool_size),
+          m_prefetch(prefetch),
+          m_fill_value(fill_value),
+          m_codec(codec),
+          p_state(std::make_unique<pool_state>())
+    {
+        if (pool_size == 0)
+        {
+            XTENSOR_THROW(std::runtime_error, "xchunk_file_store: the pool must hold at least one chunk");
+        }
+        detail::make_directory(m_directory);
+        p_state->slots.resize(pool_size);
+    }
+
+    /**
+     * Writes the modified chunks back to their files.
+     */
+    template <class T, layout_type L, class C>
+    inline xchunk_file_store<T, L, C>::~xchunk_file_store()
+    {
+        if (p_state != nullptr)
+        {
+#if !defined(XTENSOR_DISABLE_EXCEPTIONS)
+            try
+            {
+                flush();
+            }
+            catch (...)
+            {
+                // destructors must not throw, call flush to handle write errors
+            }
+#else
+            flush();
+#endif
+        }
+    }
+
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::dimension() const noexcept -> size_type
+    {
+        return m_shape.size();
+    }
+
+    /**
+     * Returns the shape of the grid of chunks.
+     */
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Returns the number of chunks.
+     */
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::chunk_shape() const noexcept -> const chunk_shape_type&
+    {
+        return m_chunk_shape;
+    }
+
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::directory() const noexcept -> const std::string&
+    {
+        return m_directory;
+    }
+
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::pool_size() const noexcept -> size_type
+    {
+        return m_pool_size;
+    }
+
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::fill_value() const noexcept -> const T&
+    {
+        return m_fill_value;
+    }
+
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::codec() const noexcept -> const codec_type&
+    {
+        return m_codec;
+    }
+
+    /**
+     * Returns the path of the file of the chunk with the given index in the
+     * row-major order of the grid.
+     */
+    template <class T, layout_type L, class C>
+    inline std::string xchunk_file_store<T, L, C>::chunk_path(size_type index) const
+    {
+        std::vector<size_type> chunk_index(m_shape.size());
+        for (size_type i = m_shape.size(); i != 0; --i)
+        {
+            chunk_index[i - 1] = index % m_shape[i - 1];
+            index /= m_shape[i - 1];
+        }
+        std::string name = m_shape.empty() ? std::string("0") : std::string();
+        for (size_type i = 0; i < chunk_index.size(); ++i)
+        {
+            name += (i == 0 ? "" : ".") + std::to_string(chunk_index[i]);
+        }
+        return m_directory + "/" + name;
+    }
+
+    /**
+     * Resizes the grid of chunks. The modified chunks are written back first.
+     */
+    template <class T, layout_type L, class C>
+    template <class S>
+    inline void xchunk_file_store<T, L, C>::resize(S&& shape)
+    {
+        flush();
+        m_shape = xtl::forward_sequence<shape_type, S>(shape);
+        m_size = compute_size(m_shape);
+        std::lock_guard<std::mutex> lock(p_state->mutex);
+        p_state->slots.assign(m_pool_size, pool_slot());
+        p_state->slot_of.assign(m_size, npos);
+        if (p_state->prefetch.valid())
+        {
+            p_state->prefetch.wait();
+            p_state->prefetch = std::future<value_type>();
+        }
+        p_state->prefetched = npos;
+    }
+
+    template <class T, layout_type L, class C>
+    template <class It>
+    inline auto xchunk_file_store<T, L, C>::element(It first, It last) -> pinned_chunk
+    {
+        return fetch(linear_index(first, last), true);
+    }
+
+    template <class T, layout_type L, class C>
+    template <class It>
+    inline auto xchunk_file_store<T, L, C>::element(It first, It last) const -> const_pinned_chunk
+    {
+        return fetch(linear_index(first, last), false);
+    }
+
+    /**
+     * Returns the chunk with the given index in the row-major order of the
+     * grid, loading it in the pool if needed. The chunk stays in the pool
+     * while the returned pointer is alive, and is written back to its file
+     * when it is evicted from the pool.
+     */
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::flat(size_type index) -> pinned_chunk
+    {
+        return fetch(index, true);
+    }
+
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::flat(size_type index) const -> const_pinned_chunk
+    {
+        return fetch(index, false);
+    }
+
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::begin() -> iterator
+    {
+        return iterator(*this, 0);
+    }
+
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::end() -> iterator
+    {
+        return iterator(*this, m_size);
+    }
+
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::begin() const -> const_iterator
+    {
+        return cbegin();
+    }
+
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::end() const -> const_iterator
+    {
+        return cend();
+    }
+
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::cbegin() const -> const_iterator
+    {
+        return const_iterator(*this, 0);
+    }
+
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::cend() const -> const_iterator
+    {
+        return const_iterator(*this, m_size);
+    }
+
+    /**
+     * Writes the modified chunks of the pool back to their files. The chunks
+     * remain in the pool, and the pinned ones are written back again when they
+     * are evicted.
+     */
+    template <class T, layout_type L, class C>
+    inline void xchunk_file_store<T, L, C>::flush()
+    {
+        std::lock_guard<std::mutex> lock(p_state->mutex);
+        for (auto& slot : p_state->slots)
+        {
+            write_back(slot);
+        }
+    }
+
+    template <class T, layout_type L, class C>
+    template <class It>
+    inline auto xchunk_file_store<T, L, C>::linear_index(It first, It last) const -> size_type
+    {
+        size_type index = 0;
+        auto shape_it = m_shape.cbegin();
+        for (; first != last; ++first, ++shape_it)
+        {
+            index = index * *shape_it + static_cast<size_type>(*first);
+        }
+        return index;
+    }
+
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::fetch(size_type index, bool dirty) const -> pinned_chunk
+    {
+        pool_state& state = *p_state;
+        std::lock_guard<std::mutex> lock(state.mutex);
+        ++state.clock;
+
+        size_type slot_index = state.slot_of[index];
+        if (slot_index == npos)
+        {
+            // the pool outgrows pool_size when all its chunks are pinned,
+            // the extra slots are released once their chunks are unpinned
+            slot_index = evict(state);
+            while (slot_index != npos && state.slots.size() > m_pool_size)
+            {
+                size_type last = state.slots.size() - 1;
+                if (slot_index != last)
+                {
+                    state.slots[slot_index] = std::move(state.slots[last]);
+                    if (state.slots[slot_index].index != npos)
+                    {
+                        state.slot_of[state.slots[slot_index].index] = slot_index;
+                    }
+                }
+                state.slots.pop_back();
+                slot_index = evict(state);
+            }
+            if (slot_index == npos)
+            {
+                slot_index = state.slots.size();
+                state.slots.emplace_back();
+            }
+
+            pool_slot& slot = state.slots[slot_index];
+            if (state.prefetched == index)
+            {
+                slot.chunk = std::make_shared<value_type>(state.prefetch.get());
+                state.prefetched = npos;
+            }
+            else
+            {
+                slot.chunk = std::make_shared<value_type>(load_chunk(chunk_path(index), m_chunk_shape, m_fill_value, m_codec));
+            }
+            slot.index = index;
+            state.slot_of[index] = slot_index;
+
+            size_type next = index + 1;
+            if (m_prefetch && state.prefetched == npos && next < m_size && state.slot_of[next] == npos)
+            {
+                state.prefetch = std::async(std::launch::async, &self_type::load_chunk,
+                                            chunk_path(next), m_chunk_shape, m_fill_value, m_codec);
+                state.prefetched = next;
+            }
+        }
+
+        pool_slot& slot = state.slots[slot_index];
+        slot.last_use = state.clock;
+        slot.dirty = slot.dirty || dirty;
+        return slot.chunk;
+    }
+
+    /**
+     * Evicts the least recently used chunk that is only held by the pool,
+     * empty slots having never been used, and returns the index of its
+     * slot, or npos when all the chunks are pinned.
+     */
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::evict(pool_state& state) const -> size_type
+    {
+        size_type slot_index = npos;
+        for (size_type i = 0; i < state.slots.size(); ++i)
+        {
+            const pool_slot& slot = state.slots[i];
+            if (slot.chunk.use_count() <= 1
+                && (slot_index == npos || slot.last_use < state.slots[slot_index].last_use))
+            {
+                slot_index = i;
+            }
+        }
+        if (slot_index != npos)
+        {
+            // synchronizes with the thread that modified the chunk and
+            // released the last pin
+            std::atomic_thread_fence(std::memory_order_acquire);
+            pool_slot& slot = state.slots[slot_index];
+            write_back(slot);
+            if (slot.index != npos)
+            {
+                state.slot_of[slot.index] = npos;
+            }
+            slot = pool_slot();
+        }
+        return slot_index;
+    }
+
+    template <class T, layout_type L, class C>
+    inline void xchunk_file_store<T, L, C>::write_back(pool_slot& slot) const
+    {
+        if (!slot.dirty)
+        {
+            return;
+        }
+        std::string path = chunk_path(slot.index);
+        std::ofstream stream(path, std::ofstream::binary);
+        if (!stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: failed to open file: " + path);
+        }
+        m_codec.encode(reinterpret_cast<const char*>(slot.chunk->data()), slot.chunk->size() * sizeof(T), stream);
+        if (!stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: failed to write file: " + path);
+        }
+        // a pinned chunk may still be modified through its pins
+        slot.dirty = slot.chunk.use_count() > 1;
+    }
+
+    template <class T, layout_type L, class C>
+    inline auto xchunk_file_store<T, L, C>::load_chunk(const std::string& path, const chunk_shape_type& chunk_shape,
+                                                       const T& fill_value, const codec_type& codec) -> value_type
+    {
+        value_type chunk = value_type::from_shape(chunk_shape);
+        std::ifstream stream(path, std::ifstream::binary);
+        if (!stream)
+        {
+            chunk.fill(fill_value);
+            return chunk;
+        }
+        if (!codec.decode(stream, reinterpret_cast<char*>(chunk.data()), chunk.size() * sizeof(T)))
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: truncated chunk file: " + path);
+        }
+        return chunk;
+    }
+
+    /***********************************
+     * xchunked_assigner for file stores *
+     ***********************************/
+
+    template <class T, class V, layout_type L, class C>
+    template <class E, class DST>
+    inline void xchunked_assigner<T, xchunk_file_store<V, L, C>>::build_and_assign_temporary(const xexpression<E>& e, DST& dst)
+    {
+        const auto& de = e.derived_cast();
+        if (detail::reads_array(de, &dst))
+        {
+            XTENSOR_THROW(std::runtime_error, "xchunk_file_store: the assigned expression reads the array, use noalias to assign it in place");
+        }
+        if (same_shape(de.shape(), dst.shape()))
+        {
+            dst.assign_xexpression(e);
+        }
+        else
+        {
+            dst.assign_xexpression(broadcast(de, dst.shape()));
+        }
+    }
+
+    /*************************************
+     * chunked_file_array implementation *
+     *************************************/
+
+    template <class T, layout_type L, class S, class C>
+    inline xchunked_array<xchunk_file_store<T, L, C>>
+    chunked_file_array(S&& shape, S&& chunk_shape, const std::string& directory,
+                       std::size_t pool_size, bool prefetch, const T& fill_value, const C& codec)
+    {
+        using chunk_storage = xchunk_file_store<T, L, C>;
+        chunk_storage store(directory, chunk_shape, pool_size, prefetch, fill_value, codec);
+        return xchunked_array<chunk_storage>(std::move(store), std::forward<S>(shape), std::forward<S>(chunk_shape), L);
+    }
+
+    template <class T, layout_type L, class S, class C>
+    inline xchunked_array<xchunk_file_store<T, L, C>>
+    chunked_file_array(std::initializer_list<S> shape, std::initializer_list<S> chunk_shape, const std::string& directory,
+                       std::size_t pool_size, bool prefetch, const T& fill_value, const C& codec)
+    {
+        using sh_type = std::vector<std::size_t>;
+        auto sh = xtl::forward_sequence<sh_type, std::initializer_list<S>>(shape);
+        auto ch_sh = xtl::forward_sequence<sh_type, std::initializer_list<S>>(chunk_shape);
+        return chunked_file_array<T, L, sh_type>(std::move(sh), std::move(ch_sh), directory, pool_size, prefetch, fill_value, codec);
+    }
+}
+
+#endif
@@ -26,12 +26,33 @@ namespace xt
     template <class chunk_storage>
     class xchunked_array;
 
+    namespace detail
+    {
+        /**
+         * References to the elements of a chunked array, and access to an
+         * element of a chunk returned by the chunk storage.
+         */
+        template <class chunk_storage>
+        struct xchunked_array_access
+        {
+            using chunk_type = typename chunk_storage::value_type;
+            using const_reference = typename chunk_type::const_reference;
+            using reference = typename chunk_type::reference;
+
+            template <class C, class It>
+            static decltype(auto) element(C&& chunk, It first, It last)
+            {
+                return chunk.element(first, last);
+            }
+        };
+    }
+
     template <class chunk_storage>
     struct xcontainer_inner_types<xchunked_array<chunk_storage>>
     {
         using chunk_type = typename chunk_storage::value_type;
-        using const_reference = typename chunk_type::const_reference;
-        using reference = typename chunk_type::reference;
+        using const_reference = typename detail::xchunked_array_access<chunk_storage>::const_reference;
+        using reference = typename detail::xchunked_array_access<chunk_storage>::reference;
         using size_type = std::size_t;
         using storage_type = chunk_type;
         using temporary_type = xchunked_array<chunk_storage>;
@@ -56,8 +77,9 @@ namespace xt
         using chunk_storage_type = chunk_storage;
         using chunk_type = typename chunk_storage::value_type;
         using grid_shape_type = typename chunk_storage::shape_type;
-        using const_reference = typename chunk_type::const_reference;
-        using reference = typename chunk_type::reference;
+        using access_type = detail::xchunked_array_access<chunk_storage>;
+        using const_reference = typename access_type::const_reference;
+        using reference = typename access_type::reference;
         using self_type = xchunked_array<chunk_storage>;
         using semantic_base = xchunked_semantic<self_type>;
         using iterable_base = xconst_iterable<self_type>;
@@ -396,8 +418,8 @@ namespace xt
     inline auto xchunked_array<CS>::operator()(Idxs... idxs) -> reference
     {
         auto ii = get_indexes(idxs...);
-        auto& chunk = m_chunks.element(ii.first.cbegin(), ii.first.cend());
-        return chunk.element(ii.second.cbegin(), ii.second.cend());
+        return access_type::element(m_chunks.element(ii.first.cbegin(), ii.first.cend()),
+                                    ii.second.cbegin(), ii.second.cend());
     }
 
     template <class CS>
@@ -405,8 +427,8 @@ namespace xt
     inline auto xchunked_array<CS>::operator()(Idxs... idxs) const -> const_reference
     {
         auto ii = get_indexes(idxs...);
-        auto& chunk = m_chunks.element(ii.first.cbegin(), ii.first.cend());
-        return chunk.element(ii.second.cbegin(), ii.second.cend());
+        return access_type::element(m_chunks.element(ii.first.cbegin(), ii.first.cend()),
+                                    ii.second.cbegin(), ii.second.cend());
     }
 
     template <class CS>
@@ -414,8 +436,8 @@ namespace xt
     inline auto xchunked_array<CS>::element(It first, It last) -> reference
     {
         auto ii = get_indexes_dynamic(first, last);
-        auto& chunk = m_chunks.element(ii.first.begin(), ii.first.end());
-        return chunk.element(ii.second.begin(), ii.second.end());
+        return access_type::element(m_chunks.element(ii.first.begin(), ii.first.end()),
+                                    ii.second.begin(), ii.second.end());
     }
 
     template <class CS>
@@ -423,8 +445,8 @@ namespace xt
     inline auto xchunked_array<CS>::element(It first, It last) const -> const_reference
     {
         auto ii = get_indexes_dynamic(first, last);
-        auto& chunk = m_chunks.element(ii.first.begin(), ii.first.end());
-        return chunk.element(ii.second.begin(), ii.second.end());
+        return access_type::element(m_chunks.element(ii.first.begin(), ii.first.end()),
+                                    ii.second.begin(), ii.second.end());
     }
 
     template <class CS>
@@ -10,6 +10,12 @@
 #ifndef XTENSOR_CHUNKED_ASSIGN_HPP
 #define XTENSOR_CHUNKED_ASSIGN_HPP
 
+#include <type_traits>
+#include <vector>
+
+#include <xtl/xtype_traits.hpp>
+
+#include "xexecution.hpp"
 #include "xnoalias.hpp"
 #include "xstrided_view.hpp"
 
@@ -83,6 +89,15 @@ namespace xt
     template <class E>
     class xchunked_view;
 
+    template <class F, class... CT>
+    class xfunction;
+
+    template <class CT, class X>
+    class xbroadcast;
+
+    template <class CT, class... S>
+    class xview;
+
     namespace detail
     {
         template <class T>
@@ -105,6 +120,43 @@ namespace xt
         {
         };
 
+        /**
+         * Whether the chunks of a chunked expression can be assigned
+         * concurrently, or read concurrently when the expression is an
+         * operand of the assigned expression; this is not the case of chunk
+         * storages that only hold a few chunks in memory at a time.
+         */
+        template <class D>
+        struct allows_parallel_chunk_assign : std::true_type
+        {
+        };
+
+        template <class E>
+        struct allows_parallel_chunk_assign<xchunked_view<E>> : allows_parallel_chunk_assign<std::decay_t<E>>
+        {
+        };
+
+        template <class F, class... CT>
+        struct allows_parallel_chunk_assign<xfunction<F, CT...>>
+            : xtl::conjunction<allows_parallel_chunk_assign<std::decay_t<CT>>...>
+        {
+        };
+
+        template <class CT, class X>
+        struct allows_parallel_chunk_assign<xbroadcast<CT, X>> : allows_parallel_chunk_assign<std::decay_t<CT>>
+        {
+        };
+
+        template <class CT, class... S>
+        struct allows_parallel_chunk_assign<xview<CT, S...>> : allows_parallel_chunk_assign<std::decay_t<CT>>
+        {
+        };
+
+        template <class CT, class S, layout_type L, class FST>
+        struct allows_parallel_chunk_assign<xstrided_view<CT, S, L, FST>> : allows_parallel_chunk_assign<std::decay_t<CT>>
+        {
+        };
+
         struct invalid_chunk_iterator {};
 
         template <class A>
@@ -197,26 +249,55 @@ namespace xt
         dst = std::move(tmp);
     }
 
+    /**
+     * Assigns e to the chunks of the derived expression. The chunks are
+     * independent, so they are distributed over the threads of the current
+     * execution policy when the chunk storages of the derived expression
+     * and of e allow it; the views on the chunks and on e are built beforehand
+     * in the calling thread, so that the lazily computed shapes of e are not
+     * shared between threads while they are computed.
+     */
     template <class D>
     template <class E>
     inline auto xchunked_semantic<D>::assign_xexpression(const xexpression<E>& e) -> derived_type&
     {
         auto& d = this->derived_cast();
         const auto& chunk_shape = d.chunk_shape();
-        size_t i = 0;
+        using iterator_type = decltype(d.chunk_begin());
+        using rhs_type = decltype(strided_view(e.derived_cast(), std::declval<const xstrided_slice_vector&>()));
+
+        std::vector<iterator_type> chunks;
+        std::vector<rhs_type> rhs;
         auto it_end = d.chunk_end();
-        for (auto it = d.chunk_begin(); it != it_end; ++it, ++i)
+        for (auto it = d.chunk_begin(); it != it_end; ++it)
         {
-            auto rhs = strided_view(e.derived_cast(), it.get_slice_vector());
-            if (rhs.shape() != chunk_shape)
-            {
-                noalias(strided_view(*it, it.get_chunk_slice_vector())) = rhs;
-            }
-            else
+            chunks.push_back(it);
+            rhs.push_back(strided_view(e.derived_cast(), it.get_slice_vector()));
+        }
+
+        constexpr bool parallel = detail::allows_parallel_chunk_assign<D>::value &&
+                                  detail::allows_parallel_chunk_assign<E>::value;
+        execution::execution_policy policy = parallel ?
+                                             execution::default_policy().with_grain_size(1) :
+                                             execution::execution_policy();
+        execution::parallel_for(policy, 0, chunks.size(),
+                                [&](std::size_t first, std::size_t last)
+        {
+            for (std::size_t i = first; i < last; ++i)
             {
-                noalias(*it) = rhs;
+                // a copy, so that the chunk pinned by dereferencing it is
+                // released once it is assigned
+                iterator_type it = chunks[i];
+                if (rhs[i].shape() != chunk_shape)
+                {
+                    noalias(strided_view(*it, it.get_chunk_slice_vector())) = rhs[i];
+                }
+                else
+                {
+                    noalias(*it) = rhs[i];
+                }
             }
-        }
+        });
 
         return this->derived_cast();
     }
@@ -10,6 +10,7 @@
 #ifndef XTENSOR_EVAL_HPP
 #define XTENSOR_EVAL_HPP
 
+#include "xexecution.hpp"
 #include "xexpression_traits.hpp"
 #include "xtensor_forward.hpp"
 #include "xshape.hpp"
@@ -48,6 +49,31 @@ namespace xt
         return std::forward<T>(t);
     }
 
+    /**
+     * Force evaluation of xexpression with the given execution policy.
+     * @return xarray or xtensor depending on shape type
+     *
+     * \code{.cpp}
+     * xarray<double> a = {1,2,3,4};
+     * auto&& b = xt::eval(a + a, xt::execution::par); // b is xarray<double>, computed in parallel
+     * \endcode
+     */
+    template <class T>
+    inline auto eval(T&& t, const execution::execution_policy& /*policy*/)
+        -> std::enable_if_t<detail::is_container<std::decay_t<T>>::value, T&&>
+    {
+        return std::forward<T>(t);
+    }
+
+    /// @cond DOXYGEN_INCLUDE_SFINAE
+    template <class T>
+    inline auto eval(T&& t, const execution::execution_policy& policy)
+        -> std::enable_if_t<!detail::is_container<std::decay_t<T>>::value, temporary_type_t<T>>
+    {
+        execution::scoped_policy guard(policy);
+        return std::forward<T>(t);
+    }
+
     namespace detail
     {
         /**********************************
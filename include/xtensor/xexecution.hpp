@@ -0,0 +1,535 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_EXECUTION_HPP
+#define XTENSOR_EXECUTION_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "xtensor_config.hpp"
+
+#if defined(XTENSOR_USE_TBB)
+#include <tbb/tbb.h>
+#endif
+
+namespace xt
+{
+    namespace execution
+    {
+        /********************
+         * execution_policy *
+         ********************/
+
+        enum class policy_type
+        {
+            sequenced,
+            parallel,
+            parallel_unsequenced
+        };
+
+        /**
+         * @class execution_policy
+         * @brief Runtime description of how an algorithm may be executed.
+         *
+         * An execution policy tells the assignment and reduction machinery whether
+         * it may split the work across threads. The grain size is the minimal
+         * number of elements processed by a single task: ranges smaller than twice
+         * the grain size are always run on the calling thread. The number of
+         * threads is an upper bound, 0 meaning "all the available threads".
+         *
+         * Whether a kernel uses SIMD instructions is decided at compile time from
+         * the expression types, therefore parallel and parallel_unsequenced policies
+         * currently behave the same way.
+         */
+        class execution_policy
+        {
+        public:
+
+            constexpr explicit execution_policy(policy_type type = policy_type::sequenced,
+                                                std::size_t grain_size = XTENSOR_DEFAULT_GRAIN_SIZE,
+                                                std::size_t num_threads = 0) noexcept;
+
+            constexpr policy_type type() const noexcept;
+            constexpr std::size_t grain_size() const noexcept;
+            constexpr std::size_t num_threads() const noexcept;
+            constexpr bool is_parallel() const noexcept;
+
+            constexpr execution_policy with_grain_size(std::size_t grain_size) const noexcept;
+            constexpr execution_policy with_num_threads(std::size_t num_threads) const noexcept;
+
+        private:
+
+            policy_type m_type;
+            std::size_t m_grain_size;
+            std::size_t m_num_threads;
+        };
+
+        execution_policy& default_policy() noexcept;
+
+        /*****************
+         * scoped_policy *
+         *****************/
+
+        /**
+         * @class scoped_policy
+         * @brief RAII helper overriding the default execution policy of the
+         * current thread for the lifetime of the object.
+         */
+        class scoped_policy
+        {
+        public:
+
+            explicit scoped_policy(const execution_policy& policy) noexcept;
+            ~scoped_policy();
+
+            scoped_policy(const scoped_policy&) = delete;
+            scoped_policy& operator=(const scoped_policy&) = delete;
+
+        private:
+
+            execution_policy m_previous;
+        };
+
+        /****************
+         * xthread_pool *
+         ****************/
+
+        /**
+         * @class xthread_pool
+         * @brief Work-stealing pool of std::thread used as the default parallel
+         * backend when neither TBB nor OpenMP is enabled.
+         *
+         * Each worker owns a task queue; it pops tasks from the front of its own
+         * queue and steals from the back of the other queues when it runs out of
+         * work. Threads submitting work to the pool help running pending tasks
+         * until their job completes, so nested parallel calls cannot deadlock.
+         */
+        class xthread_pool
+        {
+        public:
+
+            using task_type = std::function<void()>;
+
+            explicit xthread_pool(std::size_t num_workers);
+            ~xthread_pool();
+
+            xthread_pool(const xthread_pool&) = delete;
+            xthread_pool& operator=(const xthread_pool&) = delete;
+
+            std::size_t concurrency() const noexcept;
+
+            template <class F>
+            void run(std::size_t num_tasks, F&& f);
+
+            static xthread_pool& instance();
+
+        private:
+
+            struct task_queue
+            {
+                std::mutex m_mutex;
+                std::deque<task_type> m_tasks;
+            };
+
+            static std::size_t& worker_index() noexcept;
+            std::size_t home_queue() const noexcept;
+
+            void push(std::size_t queue, task_type&& task);
+            bool try_run_one(std::size_t home);
+            void worker_loop(std::size_t index);
+
+            std::vector<std::unique_ptr<task_queue>> m_queues;
+            std::vector<std::thread> m_workers;
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            std::atomic<std::size_t> m_pending;
+            bool m_stop;
+        };
+
+        template <class F>
+        void parallel_for(const execution_policy& policy, std::size_t first, std::size_t last, F&& f);
+
+        /***********************************
+         * execution_policy implementation *
+         ***********************************/
+
+        constexpr execution_policy::execution_policy(policy_type type, std::size_t grain_size, std::size_t num_threads) noexcept
+            : m_type(type), m_grain_size(grain_size == 0 ? std::size_t(1) : grain_size), m_num_threads(num_threads)
+        {
+        }
+
+        constexpr policy_type execution_policy::type() const noexcept
+        {
+            return m_type;
+        }
+
+        constexpr std::size_t execution_policy::grain_size() const noexcept
+        {
+            return m_grain_size;
+        }
+
+        constexpr std::size_t execution_policy::num_threads() const noexcept
+        {
+            return m_num_threads;
+        }
+
+        constexpr bool execution_policy::is_parallel() const noexcept
+        {
+            return m_type != policy_type::sequenced && m_num_threads != 1;
+        }
+
+        constexpr execution_policy execution_policy::with_grain_size(std::size_t grain_size) const noexcept
+        {
+            return execution_policy(m_type, grain_size, m_num_threads);
+        }
+
+        constexpr execution_policy execution_policy::with_num_threads(std::size_t num_threads) const noexcept
+        {
+            return execution_policy(m_type, m_grain_size, num_threads);
+        }
+
+        constexpr execution_policy seq = execution_policy(policy_type::sequenced);
+        constexpr execution_policy par = execution_policy(policy_type::parallel);
+        constexpr execution_policy par_unseq = execution_policy(policy_type::parallel_unsequenced);
+
+        /**
+         * Returns the execution policy used by the current thread when none
+         * is explicitly specified. It is initialized with XTENSOR_DEFAULT_EXECUTION_POLICY
+         * and can be modified, or temporarily overriden with a scoped_policy.
+         */
+        inline execution_policy& default_policy() noexcept
+        {
+            static thread_local execution_policy policy = XTENSOR_DEFAULT_EXECUTION_POLICY;
+            return policy;
+        }
+
+        /********************************
+         * scoped_policy implementation *
+         ********************************/
+
+        inline scoped_policy::scoped_policy(const execution_policy& policy) noexcept
+            : m_previous(default_policy())
+        {
+            default_policy() = policy;
+        }
+
+        inline scoped_policy::~scoped_policy()
+        {
+            default_policy() = m_previous;
+        }
+
+        /*******************************
+         * xthread_pool implementation *
+         *******************************/
+
+        inline xthread_pool::xthread_pool(std::size_t num_workers)
+            : m_pending(0), m_stop(false)
+        {
+            // The last queue is shared by the threads that do not belong to the pool
+            m_queues.reserve(num_workers + 1);
+            for (std::size_t i = 0; i < num_workers + 1; ++i)
+            {
+                m_queues.push_back(std::make_unique<task_queue>());
+            }
+            m_workers.reserve(num_workers);
+            for (std::size_t i = 0; i < num_workers; ++i)
+            {
+                m_workers.emplace_back([this, i]() { worker_loop(i); });
+            }
+        }
+
+        inline xthread_pool::~xthread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_condition.notify_all();
+            for (auto& w : m_workers)
+            {
+                w.join();
+            }
+        }
+
+        /**
+         * Returns the number of threads that can run tasks concurrently, including
+         * the thread submitting the work.
+         */
+        inline std::size_t xthread_pool::concurrency() const noexcept
+        {
+            return m_workers.size() + 1;
+        }
+
+        /**
+         * Runs f(0), ..., f(num_tasks - 1) on the pool and returns when all
+         * of them have completed. The first exception thrown by a task is
+         * rethrown in the calling thread.
+         */
+        template <class F>
+        inline void xthread_pool::run(std::size_t num_tasks, F&& f)
+        {
+            if (num_tasks == 0)
+            {
+                return;
+            }
+
+            std::atomic<std::size_t> remaining(num_tasks);
+#if !defined(XTENSOR_DISABLE_EXCEPTIONS)
+            std::exception_ptr error;
+            std::mutex error_mutex;
+#endif
+            auto wrap = [&](std::size_t i)
+            {
+                return [&f, &remaining, i
+#if !defined(XTENSOR_DISABLE_EXCEPTIONS)
+                        , &error, &error_mutex
+#endif
+                        ]()
+                {
+#if !defined(XTENSOR_DISABLE_EXCEPTIONS)
+                    try
+                    {
+                        f(i);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(error_mutex);
+                        if (!error)
+                        {
+                            error = std::current_exception();
+                        }
+                    }
+#else
+                    f(i);
+#endif
+                    remaining.fetch_sub(1, std::memory_order_acq_rel);
+                };
+            };
+
+            // Contiguous blocks of tasks are dealt to the queues so that
+            // a worker processes neighbouring chunks unless it steals.
+            std::size_t home = home_queue();
+            std::size_t nb_queues = (std::min)(m_queues.size(), num_tasks);
+            std::size_t block = (num_tasks + nb_queues - 1) / nb_queues;
+            for (std::size_t i = 0; i < num_tasks; ++i)
+            {
+                std::size_t queue = (home + i / block) % m_queues.size();
+                push(queue, wrap(i));
+            }
+            m_condition.notify_all();
+
+            while (remaining.load(std::memory_order_acquire) != 0)
+            {
+                if (!try_run_one(home))
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+#if !defined(XTENSOR_DISABLE_EXCEPTIONS)
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+#endif
+        }
+
+        /**
+         * Returns the pool shared by all the parallel algorithms of xtensor.
+         */
+        inline xthread_pool& xthread_pool::instance()
+        {
+            static xthread_pool pool((std::max)(std::thread::hardware_concurrency(), 1u) - 1u);
+            return pool;
+        }
+
+        inline std::size_t& xthread_pool::worker_index() noexcept
+        {
+            static thread_local std::size_t index = std::size_t(-1);
+            return index;
+        }
+
+        inline std::size_t xthread_pool::home_queue() const noexcept
+        {
+            std::size_t index = worker_index();
+            return index < m_workers.size() ? index : m_workers.size();
+        }
+
+        inline void xthread_pool::push(std::size_t queue, task_type&& task)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_queues[queue]->m_mutex);
+                m_queues[queue]->m_tasks.push_back(std::move(task));
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_pending;
+        }
+
+        inline bool xthread_pool::try_run_one(std::size_t home)
+        {
+            task_type task;
+            std::size_t nb_queues = m_queues.size();
+            for (std::size_t k = 0; k < nb_queues && !task; ++k)
+            {
+                task_queue& q = *m_queues[(home + k) % nb_queues];
+                std::lock_guard<std::mutex> lock(q.m_mutex);
+                if (!q.m_tasks.empty())
+                {
+                    // Own queue is consumed from the front, the others are stolen from the back
+                    if (k == 0)
+                    {
+                        task = std::move(q.m_tasks.front());
+                        q.m_tasks.pop_front();
+                    }
+                    else
+                    {
+                        task = std::move(q.m_tasks.back());
+                        q.m_tasks.pop_back();
+                    }
+                }
+            }
+            if (!task)
+            {
+                return false;
+            }
+            --m_pending;
+            task();
+            return true;
+        }
+
+        inline void xthread_pool::worker_loop(std::size_t index)
+        {
+            worker_index() = index;
+            while (true)
+            {
+                if (try_run_one(index))
+                {
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_stop || m_pending.load() != 0; });
+                if (m_stop)
+                {
+                    return;
+                }
+            }
+        }
+
+        /*******************************
+         * parallel_for implementation *
+         *******************************/
+
+        namespace detail
+        {
+            inline std::size_t backend_concurrency() noexcept
+            {
+#if defined(XTENSOR_USE_TBB) || defined(XTENSOR_USE_OPENMP)
+                return (std::max)(std::thread::hardware_concurrency(), 1u);
+#else
+                return xthread_pool::instance().concurrency();
+#endif
+            }
+        }
+
+        /**
+         * Splits the range [first, last) into chunks according to the policy and
+         * calls f(chunk_first, chunk_last) for each of them. With a sequenced
+         * policy, or when the range is too small for the grain size, f is
+         * called once on the whole range in the calling thread.
+         *
+         * The backend is TBB if XTENSOR_USE_TBB is defined, OpenMP if
+         * XTENSOR_USE_OPENMP is defined, and the xtensor thread pool otherwise.
+         */
+        template <class F>
+        inline void parallel_for(const execution_policy& policy, std::size_t first, std::size_t last, F&& f)
+        {
+            if (last <= first)
+            {
+                return;
+            }
+            std::size_t size = last - first;
+            std::size_t grain = policy.grain_size();
+#if defined(XTENSOR_USE_OPENMP)
+            std::size_t openmp_threshold = XTENSOR_OPENMP_TRESHOLD;
+            grain = (std::max)(grain, openmp_threshold / 2);
+#endif
+            if (!policy.is_parallel() || size < 2 * grain)
+            {
+                f(first, last);
+                return;
+            }
+
+            // A few chunks per thread leave room for load balancing, unless the
+            // number of threads is bounded by the policy: in that case there are
+            // never more chunks than threads allowed to run them.
+            std::size_t nb_threads = detail::backend_concurrency();
+            std::size_t nb_chunks = (std::min)(size / grain, 4 * nb_threads);
+            if (policy.num_threads() != 0)
+            {
+                nb_threads = (std::min)(nb_threads, policy.num_threads());
+                nb_chunks = (std::min)(size / grain, nb_threads);
+            }
+            if (nb_threads <= 1 || nb_chunks <= 1)
+            {
+                f(first, last);
+                return;
+            }
+            std::size_t chunk_size = (size + nb_chunks - 1) / nb_chunks;
+            nb_chunks = (size + chunk_size - 1) / chunk_size;
+
+            auto run_chunk = [&](std::size_t i)
+            {
+                std::size_t chunk_first = first + i * chunk_size;
+                std::size_t chunk_last = (std::min)(chunk_first + chunk_size, last);
+                f(chunk_first, chunk_last);
+            };
+
+#if defined(XTENSOR_USE_TBB)
+            auto body = [&run_chunk](const tbb::blocked_range<std::size_t>& r)
+            {
+                for (std::size_t i = r.begin(); i != r.end(); ++i)
+                {
+                    run_chunk(i);
+                }
+            };
+            if (policy.num_threads() != 0)
+            {
+                tbb::task_arena arena(static_cast<int>(nb_threads));
+                arena.execute([&]() { tbb::parallel_for(tbb::blocked_range<std::size_t>(0, nb_chunks), body); });
+            }
+            else
+            {
+                tbb::parallel_for(tbb::blocked_range<std::size_t>(0, nb_chunks), body);
+            }
+#elif defined(XTENSOR_USE_OPENMP)
+            auto nb = static_cast<std::ptrdiff_t>(nb_chunks);
+            #pragma omp parallel for schedule(dynamic) num_threads(static_cast<int>(nb_threads))
+            for (std::ptrdiff_t i = 0; i < nb; ++i)
+            {
+                run_chunk(static_cast<std::size_t>(i));
+            }
+#else
+            xthread_pool::instance().run(nb_chunks, run_chunk);
+#endif
+        }
+    }
+}
+
+#endif
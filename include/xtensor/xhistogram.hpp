@@ -14,6 +14,10 @@
 #ifndef XTENSOR_HISTOGRAM_HPP
 #define XTENSOR_HISTOGRAM_HPP
 
+#include <algorithm>
+#include <array>
+
+#include "xexecution.hpp"
 #include "xtensor.hpp"
 #include "xsort.hpp"
 #include "xset_operation.hpp"
@@ -46,6 +50,90 @@ namespace xt
 
     namespace detail
     {
+        // Index of the last edge lower than or equal to v, found with a
+        // branchless binary search; v must not be lower than the first edge.
+        template <class T>
+        inline std::size_t last_edge_below(const T* edges, std::size_t size, T v) noexcept
+        {
+            const T* base = edges;
+            while (size > 1)
+            {
+                std::size_t half = size / 2;
+                base = base[half] <= v ? base + half : base;
+                size -= half;
+            }
+            return static_cast<std::size_t>(base - edges);
+        }
+
+        // Adds the weights of the elements [first, last) of data to their
+        // bins, find_bin returning n_bins for the elements out of the edges.
+        template <class E1, class E3, class F, class C>
+        inline void histogram_block(const E1& data, const E3& weights, std::size_t first, std::size_t last,
+                                    std::size_t n_bins, const F& find_bin, C* count)
+        {
+            auto data_it = data.cbegin();
+            auto weight_it = weights.cbegin();
+            data_it += static_cast<std::ptrdiff_t>(first);
+            weight_it += static_cast<std::ptrdiff_t>(first);
+            for (std::size_t i = first; i < last; ++i, ++data_it, ++weight_it)
+            {
+                std::size_t bin = find_bin(*data_it);
+                if (bin < n_bins)
+                {
+                    count[bin] += *weight_it;
+                }
+            }
+        }
+
+        /**
+         * Counts the weights of the data in their bins in a single pass. With
+         * a parallel execution policy, the data is split in blocks, each block
+         * being counted in its own bins, and these bins are summed at the end.
+         * The number of blocks does not depend on the number of threads, and
+         * is bounded so that the private bins stay small compared to the data.
+         */
+        template <class E1, class E3, class F, class C>
+        inline void histogram_count(const E1& data, const E3& weights, const F& find_bin, xtensor<C, 1>& count)
+        {
+            const std::size_t size = data.size();
+            const std::size_t n_bins = count.size();
+            const execution::execution_policy& policy = execution::default_policy();
+            const std::size_t grain = policy.grain_size();
+            std::size_t nb_blocks = (std::min)({(size + grain - 1) / grain,
+                                                std::size_t(64),
+                                                (std::max)(size / n_bins, std::size_t(1))});
+            if (!policy.is_parallel() || nb_blocks < 2)
+            {
+                histogram_block(data, weights, 0, size, n_bins, find_bin, count.data());
+                return;
+            }
+
+            const std::size_t block_size = (size + nb_blocks - 1) / nb_blocks;
+            nb_blocks = (size + block_size - 1) / block_size;
+            uvector<C> block_counts(nb_blocks * n_bins, C(0));
+            execution::parallel_for(policy.with_grain_size(1), 0, nb_blocks,
+                                    [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t b = first; b < last; ++b)
+                {
+                    histogram_block(data, weights, b * block_size, (std::min)((b + 1) * block_size, size),
+                                    n_bins, find_bin, block_counts.data() + b * n_bins);
+                }
+            });
+
+            execution::parallel_for(policy, 0, n_bins, [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t b = 0; b < nb_blocks; ++b)
+                {
+                    const C* block = block_counts.data() + b * n_bins;
+                    for (std::size_t i = first; i < last; ++i)
+                    {
+                        count(i) += block[i];
+                    }
+                }
+            });
+        }
+
         template <class R = double, class E1, class E2, class E3>
         inline auto histogram_imp(E1&& data, E2&& bin_edges, E3&& weights, bool density, bool equal_bins)
         {
@@ -68,48 +156,36 @@ namespace xt
                 auto left = static_cast<double>(bounds[0]);
                 auto right = static_cast<double>(bounds[1]);
                 double norm = 1. / (right - left);
-                for (size_t i = 0; i < data.size(); ++i)
+                auto find_bin = [left, right, norm, n_bins](const auto& item)
                 {
-                    auto v = static_cast<double>(data(i));
+                    auto v = static_cast<double>(item);
                     // left and right are not bounds of data
                     if (v >= left && v < right)
                     {
                         auto i_bin = static_cast<size_t>(static_cast<double>(n_bins) * (v - left) * norm);
-                        count(i_bin) += weights(i);
+                        return (std::min)(i_bin, n_bins - 1);
                     }
-                    else if (v == right)
-                    {
-                        count(n_bins - 1) += weights(i);
-                    }
-                }
+                    return v == right ? n_bins - 1 : n_bins;
+                };
+                histogram_count(data, weights, find_bin, count);
             }
             else
             {
-                auto sorter = xt::argsort(data);
-
-                size_type ibin = 0;
-
-                for (auto& idx : sorter)
+                using edge_type = std::common_type_t<typename std::decay_t<E1>::value_type,
+                                                     typename std::decay_t<E2>::value_type>;
+                uvector<edge_type> edges(bin_edges.size());
+                std::copy(bin_edges.cbegin(), bin_edges.cend(), edges.begin());
+                const edge_type* edges_ptr = edges.data();
+                auto find_bin = [edges_ptr, n_bins](const auto& item)
                 {
-                    auto item = data[idx];
-
-                    if (item < bin_edges[0])
-                    {
-                        continue;
-                    }
-
-                    if (item > bin_edges[n_bins])
+                    auto v = static_cast<edge_type>(item);
+                    if (!(v >= edges_ptr[0] && v <= edges_ptr[n_bins]))
                     {
-                        break;
+                        return n_bins;
                     }
-
-                    while (item >= bin_edges[ibin + 1] && ibin < n_bins - 1)
-                    {
-                        ++ibin;
-                    }
-
-                    count[ibin] += weights[idx];
-                }
+                    return (std::min)(last_edge_below(edges_ptr, n_bins + 1, v), n_bins - 1);
+                };
+                histogram_count(data, weights, find_bin, count);
             }
 
             xt::xtensor<R, 1> prob = xt::cast<R>(count);
@@ -21,6 +21,7 @@
 #include "xoperation.hpp"
 #include "xsemantic.hpp"
 #include "xstrides.hpp"
+#include "xtensor.hpp"
 #include "xutils.hpp"
 
 namespace xt
@@ -727,7 +728,20 @@ namespace xt
     template <class F>
     inline auto xfiltration<ECT, CCT>::apply(F&& func) -> self_type&
     {
-        std::transform(m_e.cbegin(), m_e.cend(), m_condition.cbegin(), m_e.begin(), func);
+        // every element is written, selected or not, so that the loop has no branch;
+        // the elements are distributed over the threads of the current execution policy
+        execution::parallel_for(execution::default_policy(), 0, m_e.size(),
+                                [this, &func](std::size_t first, std::size_t last)
+        {
+            auto it = m_e.begin();
+            auto cond_it = m_condition.cbegin();
+            it += static_cast<std::ptrdiff_t>(first);
+            cond_it += static_cast<std::ptrdiff_t>(first);
+            for (std::size_t i = first; i < last; ++i, ++it, ++cond_it)
+            {
+                *it = func(*it, *cond_it);
+            }
+        });
         return *this;
     }
 
@@ -768,7 +782,8 @@ namespace xt
      * This is equivalent to \verbatim{index_view(e, argwhere(condition));}\endverbatim
      * The returned view is not optimal if you just want to assign a scalar to the filtered
      * elements. In that case, you should consider using the \ref filtration function
-     * instead.
+     * instead. Likewise, the \ref extract function copies the filtered elements to a
+     * container without building the index array.
      *
      * @tparam L the traversal order
      * @param e the underlying xexpression
@@ -790,6 +805,82 @@ namespace xt
         return view_type(std::forward<E>(e), std::move(indices));
     }
 
+    namespace detail
+    {
+        // copies the count selected elements of values to out; the loop stops at the
+        // last selected element, so that out is never written past its end
+        template <class V, class C>
+        inline void extract_chunk(const V* values, const C* condition, std::size_t count, V* out)
+        {
+            std::size_t k = 0;
+            for (std::size_t i = 0; k < count; ++i)
+            {
+                out[k] = values[i];
+                k += is_nonzero(condition[i]) ? std::size_t(1) : std::size_t(0);
+            }
+        }
+    }
+
+    /**
+     * @brief returns the elements of \a e where \a condition is true.
+     *
+     * Returns a 1D xtensor holding the same elements as \ref filter, in the
+     * L traversal order. Unlike the filter view, no index array is built: the
+     * selected elements of each chunk are counted, then copied with a branchless
+     * compress loop at the exclusive scan of the counts. Both passes are
+     * distributed over the threads of the current execution policy.
+     *
+     * @tparam L the traversal order
+     * @param condition xexpression with shape of \a e which selects the elements
+     * @param e the xexpression to extract the elements from
+     *
+     * \code{.cpp}
+     * xarray<double> a = {{1,5,3}, {4,5,6}};
+     * xtensor<double, 1> b = extract(a >= 5, a);
+     * std::cout << b << std::endl; // {5, 5, 6}
+     * \endcode
+     *
+     * \sa filter
+     */
+    template <layout_type L = XTENSOR_DEFAULT_TRAVERSAL, class C, class E>
+    inline auto extract(const xexpression<C>& condition, const xexpression<E>& e)
+    {
+        using value_type = typename E::value_type;
+        using result_type = xtensor<value_type, 1>;
+
+        const auto& dc = condition.derived_cast();
+        const auto& de = e.derived_cast();
+        if (!same_shape(dc.shape(), de.shape()))
+        {
+            XTENSOR_THROW(std::runtime_error, "extract: condition and expression must have the same shape.");
+        }
+
+        result_type res;
+        detail::nonzero_dense<L>(dc, [&](const auto* cond)
+        {
+            detail::nonzero_dense<L>(de, [&](const value_type* values)
+            {
+                const std::size_t size = de.size();
+                const std::size_t chunk_size = detail::nonzero_chunk_size();
+                const std::size_t nb_chunks = (size + chunk_size - 1) / chunk_size;
+                const std::vector<std::size_t> offsets = detail::nonzero_chunk_offsets(cond, size, chunk_size);
+                res.resize({offsets.back()});
+
+                value_type* out = res.data();
+                execution::parallel_for(execution::default_policy().with_grain_size(1), 0, nb_chunks,
+                                        [&](std::size_t first, std::size_t last)
+                {
+                    for (std::size_t c = first; c < last; ++c)
+                    {
+                        std::size_t begin = c * chunk_size;
+                        detail::extract_chunk(values + begin, cond + begin, offsets[c + 1] - offsets[c], out + offsets[c]);
+                    }
+                });
+            }, detail::has_dense_values<E>());
+        }, detail::has_dense_values<C>());
+        return res;
+    }
+
     /**
      * @brief creates a filtration of \c e filtered by \a condition.
      *
@@ -322,7 +322,23 @@ namespace xt
     template <layout_type L, class T>
     inline auto flatnonzero(const T& arr)
     {
-        return nonzero(ravel<L>(arr))[0];
+        using size_type = typename T::size_type;
+        std::vector<size_type> indices;
+        auto allocate = [&indices](std::size_t size)
+        {
+            indices.resize(size);
+        };
+        auto emit = [&indices](std::size_t position, const std::vector<std::size_t>&,
+                               const std::size_t* hits, std::size_t count)
+        {
+            std::copy(hits, hits + count, indices.begin() + static_cast<std::ptrdiff_t>(position));
+        };
+        detail::nonzero_dense<L>(arr, [&](const auto* data)
+        {
+            const std::array<std::size_t, 1> shape = {arr.size()};
+            detail::nonzero_two_pass<L>(data, shape, allocate, emit);
+        }, detail::has_dense_values<T>());
+        return indices;
     }
 
     /*****************************
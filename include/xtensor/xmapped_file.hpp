@@ -0,0 +1,175 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_MAPPED_FILE_HPP
+#define XTENSOR_MAPPED_FILE_HPP
+
+// Platform code of the memory mapping of files, only included by the
+// headers providing memory-mapped expressions.
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#define XTENSOR_UNDEF_NOMINMAX
+#endif
+#include <windows.h>
+#ifdef XTENSOR_UNDEF_NOMINMAX
+#undef NOMINMAX
+#undef XTENSOR_UNDEF_NOMINMAX
+#endif
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "xexception.hpp"
+
+namespace xt
+{
+    namespace detail
+    {
+        /**
+         * Access mode of a mapped file.
+         */
+        enum class mapped_file_mode
+        {
+            read_only,
+            read_write,
+            copy_on_write
+        };
+
+        /**
+         * RAII wrapper over a read-only or read-write mapping of a whole file.
+         * Pages are loaded lazily by the operating system and shared with the
+         * page cache of other processes mapping the same file.
+         */
+        class xmapped_file
+        {
+        public:
+
+            xmapped_file(const std::string& filename, mapped_file_mode mode);
+            ~xmapped_file();
+
+            xmapped_file(const xmapped_file&) = delete;
+            xmapped_file& operator=(const xmapped_file&) = delete;
+
+            char* data() const noexcept;
+            std::size_t size() const noexcept;
+
+        private:
+
+            char* m_data;
+            std::size_t m_size;
+#if defined(_WIN32)
+            HANDLE m_file;
+            HANDLE m_mapping;
+#endif
+        };
+
+#if defined(_WIN32)
+        inline xmapped_file::xmapped_file(const std::string& filename, mapped_file_mode mode)
+            : m_data(nullptr), m_size(0), m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+        {
+            DWORD access = mode == mapped_file_mode::read_write ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+            m_file = CreateFileA(filename.c_str(), access, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE)
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed to open file: " + filename);
+            }
+
+            LARGE_INTEGER file_size;
+            if (!GetFileSizeEx(m_file, &file_size) || file_size.QuadPart == 0)
+            {
+                CloseHandle(m_file);
+                XTENSOR_THROW(std::runtime_error, "io error: failed to map empty file: " + filename);
+            }
+            m_size = static_cast<std::size_t>(file_size.QuadPart);
+
+            DWORD protection = mode == mapped_file_mode::read_only ? PAGE_READONLY :
+                               (mode == mapped_file_mode::read_write ? PAGE_READWRITE : PAGE_WRITECOPY);
+            DWORD map_access = mode == mapped_file_mode::read_only ? FILE_MAP_READ :
+                               (mode == mapped_file_mode::read_write ? FILE_MAP_WRITE : FILE_MAP_COPY);
+            m_mapping = CreateFileMappingA(m_file, nullptr, protection, 0, 0, nullptr);
+            if (m_mapping != nullptr)
+            {
+                m_data = static_cast<char*>(MapViewOfFile(m_mapping, map_access, 0, 0, 0));
+            }
+            if (m_data == nullptr)
+            {
+                if (m_mapping != nullptr)
+                {
+                    CloseHandle(m_mapping);
+                }
+                CloseHandle(m_file);
+                XTENSOR_THROW(std::runtime_error, "io error: failed to map file: " + filename);
+            }
+        }
+
+        inline xmapped_file::~xmapped_file()
+        {
+            UnmapViewOfFile(m_data);
+            CloseHandle(m_mapping);
+            CloseHandle(m_file);
+        }
+#else
+        inline xmapped_file::xmapped_file(const std::string& filename, mapped_file_mode mode)
+            : m_data(nullptr), m_size(0)
+        {
+            int fd = ::open(filename.c_str(), mode == mapped_file_mode::read_write ? O_RDWR : O_RDONLY);
+            if (fd == -1)
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed to open file: " + filename);
+            }
+
+            struct stat file_stat;
+            if (::fstat(fd, &file_stat) == -1 || file_stat.st_size == 0)
+            {
+                ::close(fd);
+                XTENSOR_THROW(std::runtime_error, "io error: failed to map empty file: " + filename);
+            }
+            m_size = static_cast<std::size_t>(file_stat.st_size);
+
+            int protection = mode == mapped_file_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+            int flags = mode == mapped_file_mode::copy_on_write ? MAP_PRIVATE : MAP_SHARED;
+            void* addr = ::mmap(nullptr, m_size, protection, flags, fd, 0);
+            // the mapping keeps its own reference to the file
+            ::close(fd);
+            if (addr == MAP_FAILED)
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed to map file: " + filename);
+            }
+            m_data = static_cast<char*>(addr);
+        }
+
+        inline xmapped_file::~xmapped_file()
+        {
+            ::munmap(m_data, m_size);
+        }
+#endif
+
+        inline char* xmapped_file::data() const noexcept
+        {
+            return m_data;
+        }
+
+        inline std::size_t xmapped_file::size() const noexcept
+        {
+            return m_size;
+        }
+    }  // namespace detail
+}  // namespace xt
+
+#endif
@@ -662,6 +662,26 @@ namespace detail {
         };
     }
 
+    template <>
+    struct is_associative_reducer<detail::plus> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_associative_reducer<detail::multiplies> : std::true_type
+    {
+    };
+
+    template <class T>
+    struct is_associative_reducer<math::minimum<T>> : std::true_type
+    {
+    };
+
+    template <class T>
+    struct is_associative_reducer<math::maximum<T>> : std::true_type
+    {
+    };
+
     /**
      * @ingroup basic_functions
      * @brief Convert angles from degrees to radians.
@@ -1803,13 +1823,50 @@ namespace detail {
                                                        std::forward<E1>(e1), std::forward<E2>(e2));
     }
 
+    namespace detail
+    {
+        template <class E1, class E2>
+        inline bool allclose_impl(E1&& e1, E2&& e2, double rtol, double atol, std::false_type /*has_data_interface*/)
+        {
+            return xt::all(xt::isclose(std::forward<E1>(e1), std::forward<E2>(e2), rtol, atol));
+        }
+
+        template <class E1, class E2>
+        inline bool allclose_impl(E1&& e1, E2&& e2, double rtol, double atol, std::true_type /*has_data_interface*/)
+        {
+            bool dense = e1.is_contiguous() && e2.is_contiguous() &&
+                         (e1.layout() == e2.layout() || e1.dimension() <= 1) &&
+                         same_shape(e1.shape(), e2.shape());
+            if (!dense)
+            {
+                return allclose_impl(std::forward<E1>(e1), std::forward<E2>(e2), rtol, atol, std::false_type());
+            }
+
+            const auto* lhs = e1.data() + e1.data_offset();
+            const auto* rhs = e2.data() + e2.data_offset();
+            isclose close(rtol, atol, false);
+            return !any_block(e1.size(), [lhs, rhs, &close](std::size_t offset, std::size_t count)
+            {
+                std::size_t nb_close = 0;
+                for (std::size_t i = offset; i < offset + count; ++i)
+                {
+                    nb_close += close(lhs[i], rhs[i]) ? std::size_t(1) : std::size_t(0);
+                }
+                return nb_close != count;
+            });
+        }
+    }
+
     /**
      * @ingroup classif_functions
      * @brief Check if all elements in \em e1 are close to the
      * corresponding elements in \em e2.
      *
      * Returns true if all elements in ``e1`` and ``e2`` are close to each other
-     * according to parameters ``atol`` and ``rtol``.
+     * according to parameters ``atol`` and ``rtol``. Unlike ``all(isclose(e1, e2))``,
+     * contiguous operands of the same shape are compared block by block without
+     * building the intermediate expression, and the comparison stops at the first
+     * block holding elements that are not close.
      * @param e1 input array to compare
      * @param e2 input arrays to compare
      * @param rtol the relative tolerance parameter (default 1e-05)
@@ -1817,9 +1874,10 @@ namespace detail {
      * @return a boolean
      */
     template <class E1, class E2>
-    inline auto allclose(E1&& e1, E2&& e2, double rtol = 1e-05, double atol = 1e-08) noexcept
+    inline bool allclose(E1&& e1, E2&& e2, double rtol = 1e-05, double atol = 1e-08) noexcept
     {
-        return xt::all(isclose(std::forward<E1>(e1), std::forward<E2>(e2), rtol, atol));
+        using dense = xtl::conjunction<detail::has_dense_values<std::decay_t<E1>>, detail::has_dense_values<std::decay_t<E2>>>;
+        return detail::allclose_impl(std::forward<E1>(e1), std::forward<E2>(e2), rtol, atol, dense());
     }
 
     /**********************
@@ -2051,12 +2109,312 @@ namespace detail {
         }
     }
 
+    /**
+     * @class xmoments
+     * @brief Central moments of a set of values.
+     *
+     * Holds the number of values, their mean and the sums of the powers of
+     * their deviations to the mean (M2, and M3 and M4 when \em N is 4). Values
+     * are pushed one at a time with Welford's update, and two sets of moments
+     * are combined with Chan's formula, so that xmoments can be computed in a
+     * single pass by a reducer along any axes, and merged across threads.
+     *
+     * @tparam T the floating point type used for the computation.
+     * @tparam N the highest moment tracked, 2 or 4.
+     */
+    template <class T, std::size_t N = 4>
+    struct xmoments
+    {
+        static_assert(N == 2 || N == 4, "xmoments tracks either 2 or 4 moments");
+
+        using value_type = T;
+
+        value_type count = value_type(0);
+        value_type mean = value_type(0);
+        value_type m2 = value_type(0);
+        value_type m3 = value_type(0);
+        value_type m4 = value_type(0);
+
+        xmoments& push(value_type v) noexcept;
+        xmoments& merge(const xmoments& rhs) noexcept;
+
+        value_type variance(value_type ddof = value_type(0)) const noexcept;
+        value_type stddev(value_type ddof = value_type(0)) const noexcept;
+        value_type skewness() const noexcept;
+        value_type kurtosis() const noexcept;
+
+    private:
+
+        void push_higher(value_type delta_n, value_type term, std::true_type) noexcept;
+        void push_higher(value_type, value_type, std::false_type) noexcept {}
+        void merge_higher(const xmoments& rhs, value_type delta, value_type n, std::true_type) noexcept;
+        void merge_higher(const xmoments&, value_type, value_type, std::false_type) noexcept {}
+    };
+
+    template <class T, std::size_t N>
+    inline auto xmoments<T, N>::push(value_type v) noexcept -> xmoments&
+    {
+        value_type delta = v - mean;
+        count += value_type(1);
+        value_type delta_n = delta / count;
+        value_type term = delta * delta_n * (count - value_type(1));
+        mean += delta_n;
+        // M4 and M3 are updated from the previous values of M3 and M2
+        push_higher(delta_n, term, std::integral_constant<bool, (N > 2)>());
+        m2 += term;
+        return *this;
+    }
+
+    template <class T, std::size_t N>
+    inline void xmoments<T, N>::push_higher(value_type delta_n, value_type term, std::true_type) noexcept
+    {
+        value_type delta_n2 = delta_n * delta_n;
+        m4 += term * delta_n2 * (count * count - value_type(3) * count + value_type(3))
+            + value_type(6) * delta_n2 * m2 - value_type(4) * delta_n * m3;
+        m3 += term * delta_n * (count - value_type(2)) - value_type(3) * delta_n * m2;
+    }
+
+    template <class T, std::size_t N>
+    inline auto xmoments<T, N>::merge(const xmoments& rhs) noexcept -> xmoments&
+    {
+        if (rhs.count == value_type(0))
+        {
+            return *this;
+        }
+        if (count == value_type(0))
+        {
+            *this = rhs;
+            return *this;
+        }
+        value_type n = count + rhs.count;
+        value_type delta = rhs.mean - mean;
+        merge_higher(rhs, delta, n, std::integral_constant<bool, (N > 2)>());
+        m2 += rhs.m2 + delta * delta * count * rhs.count / n;
+        mean += delta * rhs.count / n;
+        count = n;
+        return *this;
+    }
+
+    template <class T, std::size_t N>
+    inline void xmoments<T, N>::merge_higher(const xmoments& rhs, value_type delta, value_type n, std::true_type) noexcept
+    {
+        value_type na = count;
+        value_type nb = rhs.count;
+        value_type delta2 = delta * delta;
+        m4 += rhs.m4 + delta2 * delta2 * na * nb * (na * na - na * nb + nb * nb) / (n * n * n)
+            + value_type(6) * delta2 * (na * na * rhs.m2 + nb * nb * m2) / (n * n)
+            + value_type(4) * delta * (na * rhs.m3 - nb * m3) / n;
+        m3 += rhs.m3 + delta2 * delta * na * nb * (na - nb) / (n * n)
+            + value_type(3) * delta * (na * rhs.m2 - nb * m2) / n;
+    }
+
+    /**
+     * Returns the variance of the values, the divisor being count - ddof.
+     */
+    template <class T, std::size_t N>
+    inline auto xmoments<T, N>::variance(value_type ddof) const noexcept -> value_type
+    {
+        return m2 / (count - ddof);
+    }
+
+    /**
+     * Returns the standard deviation of the values, the divisor of the variance
+     * being count - ddof.
+     */
+    template <class T, std::size_t N>
+    inline auto xmoments<T, N>::stddev(value_type ddof) const noexcept -> value_type
+    {
+        using std::sqrt;
+        return sqrt(variance(ddof));
+    }
+
+    /**
+     * Returns the (biased) skewness of the values. Requires N == 4.
+     */
+    template <class T, std::size_t N>
+    inline auto xmoments<T, N>::skewness() const noexcept -> value_type
+    {
+        using std::sqrt;
+        static_assert(N == 4, "skewness requires the third moment");
+        return sqrt(count) * m3 / (m2 * sqrt(m2));
+    }
+
+    /**
+     * Returns the (biased) excess kurtosis of the values. Requires N == 4.
+     */
+    template <class T, std::size_t N>
+    inline auto xmoments<T, N>::kurtosis() const noexcept -> value_type
+    {
+        static_assert(N == 4, "kurtosis requires the fourth moment");
+        return count * m4 / (m2 * m2) - value_type(3);
+    }
+
+    namespace detail
+    {
+        template <class T>
+        using moments_value_type_t = std::conditional_t<std::is_floating_point<T>::value, T, double>;
+
+        struct moments_push
+        {
+            template <class M, class V>
+            M operator()(M m, const V& v) const noexcept
+            {
+                m.push(static_cast<typename M::value_type>(v));
+                return m;
+            }
+        };
+
+        struct moments_merge
+        {
+            template <class M>
+            M operator()(M m, const M& rhs) const noexcept
+            {
+                m.merge(rhs);
+                return m;
+            }
+        };
+
+        template <class M, class E, class X, class EVS>
+        inline auto moments(E&& e, X&& axes, EVS es)
+        {
+            return xt::reduce(make_xreducer_functor(moments_push(), xt::const_value<M>(M()), moments_merge()),
+                              std::forward<E>(e), std::forward<X>(axes), es);
+        }
+
+        template <class T>
+        struct moments_variance
+        {
+            T ddof;
+
+            template <class U, std::size_t N>
+            T operator()(const xmoments<U, N>& m) const noexcept
+            {
+                return m.variance(ddof);
+            }
+        };
+    }
+
+    /**
+     * @ingroup red_functions
+     * @brief Central moments of elements over given axes.
+     *
+     * Returns an \ref xreducer computing, in a single pass over the elements of
+     * \em e, the count, mean, M2, M3 and M4 of the elements along \em axes, as
+     * an \ref xmoments. Variance, standard deviation, skewness and kurtosis are
+     * available from the result.
+     * @param e an \ref xexpression
+     * @param axes the axes along which the moments are computed (optional)
+     * @param es evaluation strategy of the reducer
+     * @tparam T the floating point type used for the computation. The default is
+     *           `E::value_type` if it is a floating point type, `double` otherwise.
+     * @return an \ref xreducer whose value type is ``xmoments<T>``
+     *
+     * @sa variance, stddev
+     */
+    template <class T = void, class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              XTL_REQUIRES(xtl::negation<is_reducer_options<X>>)>
+    inline auto moments(E&& e, X&& axes, EVS es = EVS())
+    {
+        using value_type = std::conditional_t<std::is_same<T, void>::value, typename std::decay_t<E>::value_type, T>;
+        using moments_type = xmoments<detail::moments_value_type_t<value_type>>;
+        return detail::moments<moments_type>(std::forward<E>(e), std::forward<X>(axes), es);
+    }
+
+    template <class T = void, class E, class EVS = DEFAULT_STRATEGY_REDUCERS,
+              XTL_REQUIRES(is_reducer_options<EVS>)>
+    inline auto moments(E&& e, EVS es = EVS())
+    {
+        auto ax = arange(e.dimension());
+        return moments<T>(std::forward<E>(e), std::move(ax), es);
+    }
+
+    template <class T = void, class E, class I, std::size_t N, class EVS = DEFAULT_STRATEGY_REDUCERS>
+    inline auto moments(E&& e, const I (&axes)[N], EVS es = EVS())
+    {
+        using ax_t = std::array<std::size_t, N>;
+        return moments<T>(std::forward<E>(e), xt::forward_normalize<ax_t>(e, axes), es);
+    }
+
+    namespace detail
+    {
+        // Like for mean, the value type of variance is double by default,
+        // and the type of T() + E::value_type() if it is a floating point type.
+        template <class T, class E>
+        struct variance_value_type
+        {
+            using type = moments_value_type_t<decltype(std::declval<T>() + std::declval<typename std::decay_t<E>::value_type>())>;
+        };
+
+        template <class E>
+        struct variance_value_type<void, E>
+        {
+            using type = double;
+        };
+
+        // The moments reducer only handles real floating point values, and
+        // does not implement the compensated summation algorithms.
+        template <class E, class EVS>
+        using use_moments_variance = std::integral_constant<bool,
+            std::is_floating_point<typename std::decay_t<E>::value_type>::value &&
+            std::is_same<typename reducer_options<int, EVS>::summation, summation::naive_type>::value>;
+
+        template <class T, class E, class X, class D, class EVS>
+        inline auto variance_impl(std::false_type, E&& e, X&& axes, const D& ddof, EVS es)
+        {
+            decltype(auto) sc = detail::shared_forward<E>(e);
+            // note: forcing copy of first axes argument -- is there a better solution?
+            auto axes_copy = axes;
+            // always eval to prevent repeated evaluations in the next calls
+            // the inner mean uses the same summation algorithm as the outer one
+            using inner_options = std::tuple<evaluation_strategy::immediate_type, typename reducer_options<int, EVS>::summation>;
+            auto inner_mean = eval(mean<T>(sc, std::move(axes_copy), inner_options()));
+
+            // fake keep_dims = 1
+            auto keep_dim_shape = e.shape();
+            for (const auto& el : axes)
+            {
+                keep_dim_shape[el] = 1u;
+            }
+
+            auto mrv = reshape_view<XTENSOR_DEFAULT_LAYOUT>(std::move(inner_mean), std::move(keep_dim_shape));
+            return detail::mean<T>(square(sc - std::move(mrv)), std::forward<X>(axes), ddof, es);
+        }
+
+        template <class T, class E, class X, class D, class EVS>
+        inline auto variance_impl(std::true_type, E&& e, X&& axes, const D& ddof, EVS es)
+        {
+            using value_type = typename variance_value_type<T, E>::type;
+            using moments_type = xmoments<value_type, 2>;
+            return make_lambda_xfunction(moments_variance<value_type>{static_cast<value_type>(ddof)},
+                                         moments<moments_type>(std::forward<E>(e), std::forward<X>(axes), es));
+        }
+
+        template <class T, class E, class X, class D, class EVS>
+        inline auto variance(E&& e, X&& axes, const D& ddof, EVS es)
+        {
+            return variance_impl<T>(use_moments_variance<E, EVS>(), std::forward<E>(e), std::forward<X>(axes), ddof, es);
+        }
+
+        template <class T, class E, class D, class EVS>
+        inline auto variance_noaxis(std::false_type, E&& e, const D& ddof, EVS es)
+        {
+            auto cached_mean = mean<T>(e, es)();
+            return detail::mean_noaxis<T>(square(std::forward<E>(e) - std::move(cached_mean)), ddof, es);
+        }
+
+        template <class T, class E, class D, class EVS>
+        inline auto variance_noaxis(std::true_type, E&& e, const D& ddof, EVS es)
+        {
+            auto ax = arange(e.dimension());
+            return variance_impl<T>(std::true_type(), std::forward<E>(e), std::move(ax), ddof, es);
+        }
+    }
+
     template <class T = void, class E, class D, class EVS = DEFAULT_STRATEGY_REDUCERS,
               XTL_REQUIRES(is_reducer_options<EVS>, xtl::is_integral<D>)>
     inline auto variance(E&& e, D const& ddof, EVS es = EVS())
     {
-        auto cached_mean = mean<T>(e, es)();
-        return detail::mean_noaxis<T>(square(std::forward<E>(e) - std::move(cached_mean)), ddof, es);
+        return detail::variance_noaxis<T>(detail::use_moments_variance<E, EVS>(), std::forward<E>(e), ddof, es);
     }
 
     template <class T = void, class E, class EVS = DEFAULT_STRATEGY_REDUCERS,
@@ -2079,7 +2437,10 @@ namespace detail {
      *
      * Returns the variance of the array elements, a measure of the spread of a
      * distribution. The variance is computed for the flattened array by default,
-     * otherwise over the specified axes.
+     * otherwise over the specified axes. The variance of floating point values
+     * is computed in a single pass over the elements, see \ref moments; other
+     * value types, and the pairwise and Kahan summation algorithms, go through
+     * the mean of the squared deviations from the mean.
      *
      * Note: this function is not yet specialized for complex numbers.
      *
@@ -2090,32 +2451,18 @@ namespace detail {
                    elements. By default ddof is zero.
      * @param es evaluation strategy to use (lazy (default), or immediate)
      * @tparam T the value type used for internal computation. The default is
-     *           `E::value_type`. `T`is also used for determining the value type of the result,
-     *           which is the type of `T() + E::value_type()`.
-     *           You can pass `big_promote_value_type_t<E>` to avoid overflow in computation.
+     *           `double`. Otherwise the type of `T() + E::value_type()` is used
+     *           if it is a floating point type, `double` if it is not. When the
+     *           mean of the squared deviations is computed, T is used like in mean.
      * @return an \ref xexpression
      *
-     * @sa stddev, mean
+     * @sa stddev, mean, moments
      */
     template <class T = void, class E, class X, class D, class EVS = DEFAULT_STRATEGY_REDUCERS,
               XTL_REQUIRES(xtl::negation<is_reducer_options<X>>, xtl::is_integral<D>)>
     inline auto variance(E&& e, X&& axes, const D& ddof, EVS es = EVS())
     {
-        decltype(auto) sc = detail::shared_forward<E>(e);
-        // note: forcing copy of first axes argument -- is there a better solution?
-        auto axes_copy = axes;
-        // always eval to prevent repeated evaluations in the next calls
-        auto inner_mean = eval(mean<T>(sc, std::move(axes_copy), evaluation_strategy::immediate));
-
-        // fake keep_dims = 1
-        auto keep_dim_shape = e.shape();
-        for (const auto& el : axes)
-        {
-            keep_dim_shape[el] = 1u;
-        }
-
-        auto mrv = reshape_view<XTENSOR_DEFAULT_LAYOUT>(std::move(inner_mean), std::move(keep_dim_shape));
-        return detail::mean<T>(square(sc - std::move(mrv)), std::forward<X>(axes), ddof, es);
+        return detail::variance<T>(std::forward<E>(e), std::forward<X>(axes), ddof, es);
     }
 
     template <class T = void, class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,
@@ -2253,6 +2600,56 @@ namespace detail {
                           std::forward<E>(e));
     }
 
+    namespace detail
+    {
+        template <class T, class E, class S>
+        using use_compensated_cumsum = std::integral_constant<bool,
+            !std::is_same<S, summation::naive_type>::value &&
+            std::is_floating_point<std::decay_t<decltype(std::declval<T>() + std::declval<typename std::decay_t<E>::value_type>())>>::value>;
+
+        template <class T, class E, class... A>
+        inline auto cumsum_impl(std::false_type, E&& e, A... axis)
+        {
+            return cumsum<T>(std::forward<E>(e), axis...);
+        }
+
+        template <class T, class E, class... A>
+        inline auto cumsum_impl(std::true_type, E&& e, A... axis)
+        {
+            return compensated_cumsum<T>(std::forward<E>(e), normalize_axis(e.dimension(), axis)...);
+        }
+    }
+
+    /**
+     * @ingroup acc_functions
+     * @brief Cumulative sum with a given summation algorithm.
+     *
+     * Returns the accumulated sum for the elements over given
+     * \em axis (or flattened). When \em options contains
+     * ``summation::kahan`` or ``summation::pairwise`` and the result is
+     * a floating point type, the running sums are compensated so that
+     * the error does not grow with the number of accumulated elements.
+     * @param e an \ref xexpression
+     * @param axis the axes along which the cumulative sum is computed (optional)
+     * @param options a tuple of options, e.g. ``summation::kahan``
+     * @return an \ref xarray<T>
+     */
+    template <class T = void, class E, class O, XTL_REQUIRES(is_reducer_options<O>)>
+    inline auto cumsum(E&& e, std::ptrdiff_t axis, O)
+    {
+        using init_value_type = std::conditional_t<std::is_same<T, void>::value, typename std::decay_t<E>::value_type, T>;
+        using compensated = detail::use_compensated_cumsum<init_value_type, E, typename reducer_options<init_value_type, O>::summation>;
+        return detail::cumsum_impl<init_value_type>(compensated(), std::forward<E>(e), axis);
+    }
+
+    template <class T = void, class E, class O, XTL_REQUIRES(is_reducer_options<O>)>
+    inline auto cumsum(E&& e, O)
+    {
+        using init_value_type = std::conditional_t<std::is_same<T, void>::value, typename std::decay_t<E>::value_type, T>;
+        using compensated = detail::use_compensated_cumsum<init_value_type, E, typename reducer_options<init_value_type, O>::summation>;
+        return detail::cumsum_impl<init_value_type>(compensated(), std::forward<E>(e));
+    }
+
     /**
      * @ingroup acc_functions
      * @brief Cumulative product.
@@ -2368,6 +2765,26 @@ namespace detail {
         };
     }
 
+    template <>
+    struct is_associative_reducer<detail::nan_min> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_associative_reducer<detail::nan_max> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_associative_reducer<detail::nan_plus> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_associative_reducer<detail::nan_multiplies> : std::true_type
+    {
+    };
+
     /**
      * @defgroup  nan_functions nan functions
      */
@@ -10,6 +10,7 @@
 #ifndef XTENSOR_NOALIAS_HPP
 #define XTENSOR_NOALIAS_HPP
 
+#include "xexecution.hpp"
 #include "xsemantic.hpp"
 
 namespace xt
@@ -21,7 +22,7 @@ namespace xt
 
     public:
 
-        noalias_proxy(A a) noexcept;
+        noalias_proxy(A a, const execution::execution_policy& policy) noexcept;
 
         template <class E>
         disable_xexpression<E, A> operator=(const E&);
@@ -80,18 +81,22 @@ namespace xt
     private:
 
         A m_array;
+        execution::execution_policy m_policy;
     };
 
     template <class A>
     noalias_proxy<xtl::closure_type_t<A>> noalias(A&& a) noexcept;
 
+    template <class A>
+    noalias_proxy<xtl::closure_type_t<A>> noalias(A&& a, const execution::execution_policy& policy) noexcept;
+
     /********************************
      * noalias_proxy implementation *
      ********************************/
 
     template <class A>
-    inline noalias_proxy<A>::noalias_proxy(A a) noexcept
-        : m_array(std::forward<A>(a))
+    inline noalias_proxy<A>::noalias_proxy(A a, const execution::execution_policy& policy) noexcept
+        : m_array(std::forward<A>(a)), m_policy(policy)
     {
     }
 
@@ -99,6 +104,7 @@ namespace xt
     template <class E>
     inline auto noalias_proxy<A>::operator=(const E& e) -> disable_xexpression<E, A>
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.assign(xscalar<E>(e));
     }
 
@@ -106,6 +112,7 @@ namespace xt
     template <class E>
     inline auto noalias_proxy<A>::operator+=(const E& e) -> disable_xexpression<E, A>
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.scalar_computed_assign(e, std::plus<>());
     }
 
@@ -113,6 +120,7 @@ namespace xt
     template <class E>
     inline auto noalias_proxy<A>::operator-=(const E& e) -> disable_xexpression<E, A>
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.scalar_computed_assign(e, std::minus<>());
     }
 
@@ -120,6 +128,7 @@ namespace xt
     template <class E>
     inline auto noalias_proxy<A>::operator*=(const E& e) -> disable_xexpression<E, A>
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.scalar_computed_assign(e, std::multiplies<>());
     }
 
@@ -127,6 +136,7 @@ namespace xt
     template <class E>
     inline auto noalias_proxy<A>::operator/=(const E& e) -> disable_xexpression<E, A>
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.scalar_computed_assign(e, std::divides<>());
     }
 
@@ -134,6 +144,7 @@ namespace xt
     template <class E>
     inline auto noalias_proxy<A>::operator%=(const E& e) -> disable_xexpression<E, A>
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.scalar_computed_assign(e, std::modulus<>());
     }
 
@@ -141,6 +152,7 @@ namespace xt
     template <class E>
     inline auto noalias_proxy<A>::operator&=(const E& e) -> disable_xexpression<E, A>
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.scalar_computed_assign(e, std::bit_and<>());
     }
 
@@ -148,6 +160,7 @@ namespace xt
     template <class E>
     inline auto noalias_proxy<A>::operator|=(const E& e) -> disable_xexpression<E, A>
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.scalar_computed_assign(e, std::bit_or<>());
     }
 
@@ -155,6 +168,7 @@ namespace xt
     template <class E>
     inline auto noalias_proxy<A>::operator^=(const E& e) -> disable_xexpression<E, A>
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.scalar_computed_assign(e, std::bit_xor<>());
     }
 
@@ -162,6 +176,7 @@ namespace xt
     template <class E>
     inline A noalias_proxy<A>::operator=(const xexpression<E>& e)
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.assign(e);
     }
 
@@ -169,6 +184,7 @@ namespace xt
     template <class E>
     inline A noalias_proxy<A>::operator+=(const xexpression<E>& e)
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.plus_assign(e);
     }
 
@@ -176,6 +192,7 @@ namespace xt
     template <class E>
     inline A noalias_proxy<A>::operator-=(const xexpression<E>& e)
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.minus_assign(e);
     }
 
@@ -183,6 +200,7 @@ namespace xt
     template <class E>
     inline A noalias_proxy<A>::operator*=(const xexpression<E>& e)
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.multiplies_assign(e);
     }
 
@@ -190,6 +208,7 @@ namespace xt
     template <class E>
     inline A noalias_proxy<A>::operator/=(const xexpression<E>& e)
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.divides_assign(e);
     }
 
@@ -197,6 +216,7 @@ namespace xt
     template <class E>
     inline A noalias_proxy<A>::operator%=(const xexpression<E>& e)
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.modulus_assign(e);
     }
 
@@ -204,6 +224,7 @@ namespace xt
     template <class E>
     inline A noalias_proxy<A>::operator&=(const xexpression<E>& e)
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.bit_and_assign(e);
     }
 
@@ -211,6 +232,7 @@ namespace xt
     template <class E>
     inline A noalias_proxy<A>::operator|=(const xexpression<E>& e)
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.bit_or_assign(e);
     }
 
@@ -218,6 +240,7 @@ namespace xt
     template <class E>
     inline A noalias_proxy<A>::operator^=(const xexpression<E>& e)
     {
+        execution::scoped_policy guard(m_policy);
         return m_array.bit_xor_assign(e);
     }
 
@@ -225,7 +248,23 @@ namespace xt
     inline noalias_proxy<xtl::closure_type_t<A>>
     noalias(A&& a) noexcept
     {
-        return noalias_proxy<xtl::closure_type_t<A>>(a);
+        return noalias_proxy<xtl::closure_type_t<A>>(a, execution::default_policy());
+    }
+
+    /**
+     * Same as noalias(a), but the assignment is performed with the given
+     * execution policy instead of the default policy of the current thread.
+     *
+     * \code{.cpp}
+     * xt::noalias(b, xt::execution::par) = a + 2 * c;
+     * xt::noalias(d, xt::execution::par.with_num_threads(4)) = a * c;
+     * \endcode
+     */
+    template <class A>
+    inline noalias_proxy<xtl::closure_type_t<A>>
+    noalias(A&& a, const execution::execution_policy& policy) noexcept
+    {
+        return noalias_proxy<xtl::closure_type_t<A>>(a, policy);
     }
 }
 
@@ -600,7 +600,8 @@ namespace xt
             char* m_buffer;
         };
 
-        inline npy_file load_npy_file(std::istream& stream)
+        inline void read_npy_header(std::istream& stream, std::string& typestr,
+                                    bool* fortran_order, std::vector<std::size_t>& shape)
         {
             // check magic bytes an version number
             unsigned char v_major, v_minor;
@@ -622,11 +623,15 @@ namespace xt
             }
 
             // parse header
+            detail::parse_header(header, typestr, fortran_order, shape);
+        }
+
+        inline npy_file load_npy_file(std::istream& stream)
+        {
             bool fortran_order;
             std::string typestr;
-
             std::vector<std::size_t> shape;
-            detail::parse_header(header, typestr, &fortran_order, shape);
+            detail::read_npy_header(stream, typestr, &fortran_order, shape);
 
             npy_file result(shape, fortran_order, typestr);
             // read the data
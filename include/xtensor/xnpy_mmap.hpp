@@ -0,0 +1,136 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_NPY_MMAP_HPP
+#define XTENSOR_NPY_MMAP_HPP
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "xtensor/xadapt.hpp"
+#include "xtensor/xmapped_file.hpp"
+#include "xtensor/xnpy.hpp"
+
+namespace xt
+{
+    /**
+     * Access modes of a memory-mapped npy file.
+     */
+    namespace mmap_mode
+    {
+        /**
+         *  The mapping is read-only, the returned adaptor only gives const access
+         */
+        struct read_only_type
+        {
+        };
+        constexpr read_only_type read_only = {};
+
+        /**
+         *  Changes are written back to the file and shared with other processes
+         */
+        struct read_write_type
+        {
+        };
+        constexpr read_write_type read_write = {};
+
+        /**
+         *  Changes stay private to the mapping, the file is not modified
+         */
+        struct copy_on_write_type
+        {
+        };
+        constexpr copy_on_write_type copy_on_write = {};
+    }
+
+    namespace detail
+    {
+        inline mapped_file_mode get_mapped_file_mode(mmap_mode::read_only_type)
+        {
+            return mapped_file_mode::read_only;
+        }
+
+        inline mapped_file_mode get_mapped_file_mode(mmap_mode::read_write_type)
+        {
+            return mapped_file_mode::read_write;
+        }
+
+        inline mapped_file_mode get_mapped_file_mode(mmap_mode::copy_on_write_type)
+        {
+            return mapped_file_mode::copy_on_write;
+        }
+
+        template <class T, class M>
+        using mmap_value_type_t = std::conditional_t<std::is_same<M, mmap_mode::read_only_type>::value, const T, T>;
+    }
+
+    /**
+     * Memory-maps a npy file (the numpy storage format)
+     *
+     * Only the header is read, the returned adaptor points to the data of the
+     * mapped file: pages are loaded on first access and the page cache is
+     * shared with other processes mapping the file. The mapping is released
+     * when the last copy of the adaptor is destroyed.
+     *
+     * @param filename The filename or path to the file
+     * @param mode Access mode of the mapping, one of mmap_mode::read_only,
+     *             mmap_mode::read_write or mmap_mode::copy_on_write
+     * @tparam T select the type of the npy file, which must match the stored type
+     * @tparam L select layout_type::column_major if you stored data in
+     *           Fortran format
+     * @return xarray_adaptor on the contents of the npy file, over const
+     *         elements for a read-only mapping
+     */
+    template <typename T, layout_type L = layout_type::dynamic, class M = mmap_mode::read_only_type>
+    inline auto mmap_npy(const std::string& filename, M mode = M())
+    {
+        bool fortran_order;
+        std::string typestr;
+        std::vector<std::size_t> shape;
+        std::size_t offset;
+        {
+            std::ifstream stream(filename, std::ifstream::binary);
+            if (!stream)
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed to open a file.");
+            }
+            detail::read_npy_header(stream, typestr, &fortran_order, shape);
+            offset = static_cast<std::size_t>(stream.tellg());
+        }
+
+        if (typestr != detail::build_typestring<T>())
+        {
+            XTENSOR_THROW(std::runtime_error,
+                          "Cast error: formats not matching " + typestr +
+                          " vs " + detail::build_typestring<T>());
+        }
+
+        layout_type file_layout = fortran_order ? layout_type::column_major : layout_type::row_major;
+        if (L != layout_type::dynamic && L != file_layout)
+        {
+            XTENSOR_THROW(std::runtime_error, "Cast error: layout mismatch between npy file and requested layout.");
+        }
+
+        auto file = std::make_shared<detail::xmapped_file>(filename, detail::get_mapped_file_mode(mode));
+        if (file->size() < offset + compute_size(shape) * sizeof(T))
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: npy file is truncated.");
+        }
+
+        using value_type = detail::mmap_value_type_t<T, M>;
+        value_type* ptr = reinterpret_cast<value_type*>(file->data() + offset);
+        return adapt_smart_ptr<L>(std::move(ptr), shape, std::move(file), file_layout);
+    }
+}
+
+#endif
@@ -11,13 +11,19 @@
 #define XTENSOR_OPERATION_HPP
 
 #include <algorithm>
+#include <cstddef>
 #include <functional>
+#include <numeric>
 #include <type_traits>
+#include <vector>
 
+#include <xtl/xoptional.hpp>
 #include <xtl/xsequence.hpp>
 
+#include "xexecution.hpp"
 #include "xfunction.hpp"
 #include "xscalar.hpp"
+#include "xstorage.hpp"
 #include "xstrides.hpp"
 #include "xstrided_view.hpp"
 
@@ -866,10 +872,216 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
         }
     }
 
+    namespace detail
+    {
+        // Expressions whose elements can be read through a plain pointer; optional
+        // assemblies expose a data method but store their values and flags apart.
+        template <class T>
+        using has_dense_values = xtl::conjunction<has_data_interface<T>, std::is_arithmetic<typename T::value_type>>;
+
+        template <layout_type L, class T, class F>
+        inline void nonzero_dense(const T& arr, F&& fct, std::false_type /*has_data_interface*/)
+        {
+            using value_type = typename T::value_type;
+            uvector<value_type> buffer(arr.size());
+            execution::parallel_for(execution::default_policy(), 0, buffer.size(),
+                                    [&](std::size_t first, std::size_t last)
+            {
+                auto it = arr.template begin<L>();
+                it += static_cast<std::ptrdiff_t>(first);
+                std::copy_n(it, last - first, buffer.begin() + static_cast<std::ptrdiff_t>(first));
+            });
+            const value_type* data = buffer.data();
+            fct(data);
+        }
+
+        /**
+         * Calls fct with a pointer to the elements of arr in the L traversal
+         * order: the storage of contiguous containers and views is used as is,
+         * other expressions are evaluated into a temporary buffer.
+         */
+        template <layout_type L, class T, class F>
+        inline void nonzero_dense(const T& arr, F&& fct, std::true_type /*has_data_interface*/)
+        {
+            if ((arr.layout() == L || arr.dimension() <= 1) && arr.is_contiguous())
+            {
+                fct(arr.data() + arr.data_offset());
+            }
+            else
+            {
+                nonzero_dense<L>(arr, std::forward<F>(fct), std::false_type());
+            }
+        }
+
+        template <class V>
+        inline bool is_nonzero(const V& value)
+        {
+            return value ? true : false;
+        }
+
+        // missing values are not non-zero
+        template <class CT, class CB>
+        inline bool is_nonzero(const xtl::xoptional<CT, CB>& value)
+        {
+            return value.has_value() && is_nonzero(value.value());
+        }
+
+        template <class V>
+        inline std::size_t nonzero_count(const V* first, std::size_t size)
+        {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                count += is_nonzero(first[i]) ? std::size_t(1) : std::size_t(0);
+            }
+            return count;
+        }
+
+        /**
+         * Counts the non-zero elements of the chunks of chunk_size elements of
+         * [data, data + size) with the threads of the current execution policy,
+         * and returns the exclusive scan of the counts followed by the total.
+         */
+        template <class V>
+        inline std::vector<std::size_t> nonzero_chunk_offsets(const V* data, std::size_t size, std::size_t chunk_size)
+        {
+            const std::size_t nb_chunks = (size + chunk_size - 1) / chunk_size;
+            std::vector<std::size_t> offsets(nb_chunks + 1, 0);
+            execution::parallel_for(execution::default_policy().with_grain_size(1), 0, nb_chunks,
+                                    [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    std::size_t begin = c * chunk_size;
+                    offsets[c + 1] = nonzero_count(data + begin, (std::min)(chunk_size, size - begin));
+                }
+            });
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+            return offsets;
+        }
+
+        inline std::size_t nonzero_chunk_size()
+        {
+            return (std::max)(execution::default_policy().grain_size(), std::size_t(1));
+        }
+
+        // writes the positions of the non-zero elements of [first, first + size) to hits,
+        // which must hold size + 1 elements
+        template <class V>
+        inline std::size_t nonzero_compress(const V* first, std::size_t size, std::size_t offset, std::size_t* hits)
+        {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                hits[count] = offset + i;
+                count += is_nonzero(first[i]) ? std::size_t(1) : std::size_t(0);
+            }
+            return count;
+        }
+
+        /**
+         * Finds the non-zero elements of the dense data of the given shape, stored
+         * in the L order, in two passes. The elements are split in chunks that are
+         * distributed over the threads of the current execution policy: the first
+         * pass counts the non-zero elements of each chunk, then allocate(total) is
+         * called and the second pass writes each chunk at the exclusive scan of the
+         * counts.
+         * The rows of the data lie along the fastest axis of L. The positions in the
+         * row of the non-zero elements of a row segment are given to
+         * emit(position, index, hits, count), where index holds the index of the row
+         * (its component along the row axis is unspecified).
+         */
+        template <layout_type L, class V, class S, class A, class F>
+        inline void nonzero_two_pass(const V* data, const S& shape, A&& allocate, F&& emit)
+        {
+            const std::size_t dim = shape.size();
+            const std::size_t size = compute_size(shape);
+            if (size == 0)
+            {
+                allocate(std::size_t(0));
+                return;
+            }
+
+            const std::size_t row_axis = L == layout_type::row_major ? dim - 1 : 0;
+            const std::size_t row_size = shape[row_axis];
+            // outer axes, from the fastest to the slowest one
+            std::vector<std::size_t> outer_axes;
+            for (std::size_t i = 1; i < dim; ++i)
+            {
+                outer_axes.push_back(L == layout_type::row_major ? dim - 1 - i : i);
+            }
+
+            const std::size_t chunk_size = nonzero_chunk_size();
+            const std::size_t nb_chunks = (size + chunk_size - 1) / chunk_size;
+            const std::vector<std::size_t> offsets = nonzero_chunk_offsets(data, size, chunk_size);
+            allocate(offsets.back());
+
+            execution::parallel_for(execution::default_policy().with_grain_size(1), 0, nb_chunks,
+                                    [&](std::size_t first, std::size_t last)
+            {
+                std::vector<std::size_t> index(dim, 0);
+                uvector<std::size_t> hits((std::min)(chunk_size, row_size) + 1);
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    std::size_t begin = c * chunk_size;
+                    std::size_t end = (std::min)(begin + chunk_size, size);
+                    std::size_t position = offsets[c];
+                    if (position == offsets[c + 1])
+                    {
+                        continue;
+                    }
+
+                    std::size_t row = begin / row_size;
+                    std::size_t rem = row;
+                    for (std::size_t axis : outer_axes)
+                    {
+                        index[axis] = rem % shape[axis];
+                        rem /= shape[axis];
+                    }
+
+                    std::size_t row_first = begin - row * row_size;
+                    while (begin < end)
+                    {
+                        std::size_t count = (std::min)(row_size - row_first, end - begin);
+                        std::size_t nb_hits = nonzero_compress(data + begin, count, row_first, hits.data());
+                        if (nb_hits != 0)
+                        {
+                            emit(position, index, hits.data(), nb_hits);
+                            position += nb_hits;
+                        }
+                        begin += count;
+                        row_first = 0;
+                        for (std::size_t axis : outer_axes)
+                        {
+                            if (++index[axis] < shape[axis])
+                            {
+                                break;
+                            }
+                            index[axis] = 0;
+                        }
+                    }
+                }
+            });
+        }
+
+        template <layout_type L, class T, class A, class F>
+        inline void nonzero_impl(const T& arr, A&& allocate, F&& emit)
+        {
+            nonzero_dense<L>(arr, [&](const auto* data)
+            {
+                nonzero_two_pass<L>(data, arr.shape(), allocate, emit);
+            }, has_dense_values<T>());
+        }
+    }
+
     /**
      * @ingroup logical_operators
      * @brief return vector of indices where T is not zero
      *
+     * The non-zero elements are counted first, so that the result is allocated
+     * once with its final size, then the indices are written; both passes are
+     * distributed over the threads of the current execution policy.
+     *
      * @param arr input array
      * @return vector of vectors, one for each dimension of arr, containing
      * the indices of the non-zero elements in that dimension
@@ -877,25 +1089,41 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
     template <class T>
     inline auto nonzero(const T& arr)
     {
-        auto shape = arr.shape();
-        using index_type = xindex_type_t<typename T::shape_type>;
         using size_type = typename T::size_type;
+        constexpr layout_type L = XTENSOR_DEFAULT_TRAVERSAL;
 
-        auto idx = xtl::make_sequence<index_type>(arr.dimension(), 0);
-        std::vector<std::vector<size_type>> indices(arr.dimension());
+        const std::size_t dim = arr.dimension();
+        std::vector<std::vector<size_type>> indices(dim);
+        if (dim == 0)
+        {
+            return indices;
+        }
 
-        size_type total_size = compute_size(shape);
-        for (size_type i = 0; i < total_size; i++, detail::next_idx(shape, idx))
+        const std::size_t row_axis = L == layout_type::row_major ? dim - 1 : 0;
+        auto allocate = [&indices](std::size_t size)
         {
-            if (arr.element(std::begin(idx), std::end(idx)))
+            for (auto& axis_indices : indices)
+            {
+                axis_indices.resize(size);
+            }
+        };
+        auto emit = [&indices, row_axis](std::size_t position, const std::vector<std::size_t>& index,
+                                         const std::size_t* hits, std::size_t count)
+        {
+            auto first = static_cast<std::ptrdiff_t>(position);
+            for (std::size_t n = 0; n < indices.size(); ++n)
             {
-                for (std::size_t n = 0; n < indices.size(); ++n)
+                if (n == row_axis)
+                {
+                    std::copy(hits, hits + count, indices[n].begin() + first);
+                }
+                else
                 {
-                    indices.at(n).push_back(idx[n]);
+                    std::fill_n(indices[n].begin() + first, count, static_cast<size_type>(index[n]));
                 }
             }
-        }
-
+        };
+        detail::nonzero_impl<L>(arr, allocate, emit);
         return indices;
     }
 
@@ -917,6 +1145,9 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
      * @ingroup logical_operators
      * @brief return vector of indices where arr is not zero
      *
+     * Like nonzero, the result is allocated once with its final size and
+     * filled with the threads of the current execution policy.
+     *
      * @tparam L the traversal order
      * @param arr input array
      * @return vector of index_types where arr is not equal to zero (use `xt::from_indices` to convert)
@@ -926,40 +1157,124 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
     template <layout_type L = XTENSOR_DEFAULT_TRAVERSAL, class T>
     inline auto argwhere(const T& arr)
     {
-        auto shape = arr.shape();
         using index_type = xindex_type_t<typename T::shape_type>;
-        using size_type = typename T::size_type;
 
-        auto idx = xtl::make_sequence<index_type>(arr.dimension(), 0);
+        const std::size_t dim = arr.dimension();
+        auto idx = xtl::make_sequence<index_type>(dim, 0);
         std::vector<index_type> indices;
-
-        size_type total_size = compute_size(shape);
-        for (size_type i = 0; i < total_size; i++, detail::next_idx<L>(shape, idx))
+        if (dim == 0)
         {
             if (arr.element(std::begin(idx), std::end(idx)))
             {
                 indices.push_back(idx);
             }
+            return indices;
         }
 
+        const std::size_t row_axis = L == layout_type::row_major ? dim - 1 : 0;
+        auto allocate = [&indices, &idx](std::size_t size)
+        {
+            indices.resize(size, idx);
+        };
+        auto emit = [&indices, dim, row_axis](std::size_t position, const std::vector<std::size_t>& index,
+                                              const std::size_t* hits, std::size_t count)
+        {
+            using value_type = typename index_type::value_type;
+            for (std::size_t h = 0; h < count; ++h)
+            {
+                auto& res = indices[position + h];
+                for (std::size_t n = 0; n < dim; ++n)
+                {
+                    res[n] = static_cast<value_type>(index[n]);
+                }
+                res[row_axis] = static_cast<value_type>(hits[h]);
+            }
+        };
+        detail::nonzero_impl<L>(arr, allocate, emit);
         return indices;
     }
 
+    namespace detail
+    {
+        // Number of elements tested at once by the boolean reductions before
+        // checking for an early exit
+        constexpr std::size_t boolean_block_size = 1024;
+
+        /**
+         * Returns true at the first block of [0, size) for which
+         * pred(offset, count) holds, false if there is none.
+         */
+        template <class P>
+        inline bool any_block(std::size_t size, P&& pred)
+        {
+            for (std::size_t offset = 0; offset < size; offset += boolean_block_size)
+            {
+                if (pred(offset, (std::min)(boolean_block_size, size - offset)))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template <class T>
+        inline bool any_truthy(const T& arr, std::false_type /*has_data_interface*/)
+        {
+            using value_type = typename T::value_type;
+            return std::any_of(arr.cbegin(), arr.cend(), [](const value_type& el) { return el; });
+        }
+
+        template <class T>
+        inline bool any_truthy(const T& arr, std::true_type /*has_data_interface*/)
+        {
+            if (!arr.is_contiguous())
+            {
+                return any_truthy(arr, std::false_type());
+            }
+            const auto* data = arr.data() + arr.data_offset();
+            return any_block(arr.size(), [data](std::size_t offset, std::size_t count)
+            {
+                return nonzero_count(data + offset, count) != 0;
+            });
+        }
+
+        template <class T>
+        inline bool all_truthy(const T& arr, std::false_type /*has_data_interface*/)
+        {
+            using value_type = typename T::value_type;
+            return std::all_of(arr.cbegin(), arr.cend(), [](const value_type& el) { return el; });
+        }
+
+        template <class T>
+        inline bool all_truthy(const T& arr, std::true_type /*has_data_interface*/)
+        {
+            if (!arr.is_contiguous())
+            {
+                return all_truthy(arr, std::false_type());
+            }
+            const auto* data = arr.data() + arr.data_offset();
+            return !any_block(arr.size(), [data](std::size_t offset, std::size_t count)
+            {
+                return nonzero_count(data + offset, count) != count;
+            });
+        }
+    }
+
     /**
     * @ingroup logical_operators
     * @brief Any
     *
     * Returns true if any of the values of \a e is truthy,
     * false otherwise.
+    * The storage of contiguous expressions is tested by blocks, and the
+    * search stops at the first block holding a truthy value.
     * @param e an \ref xexpression
     * @return a boolean
     */
     template <class E>
     inline bool any(E&& e)
     {
-        using xtype = std::decay_t<E>;
-        using value_type = typename xtype::value_type;
-        return std::any_of(e.cbegin(), e.cend(), [](const value_type& el) { return el; });
+        return detail::any_truthy(e, detail::has_dense_values<std::decay_t<E>>());
     }
 
     /**
@@ -968,15 +1283,15 @@ constexpr auto operator OP(const std::complex<T1>& arg1, const T2& arg2)
     *
     * Returns true if all of the values of \a e are truthy,
     * false otherwise.
+    * The storage of contiguous expressions is tested by blocks, and the
+    * search stops at the first block holding a falsy value.
     * @param e an \ref xexpression
     * @return a boolean
     */
     template <class E>
     inline bool all(E&& e)
     {
-        using xtype = std::decay_t<E>;
-        using value_type = typename xtype::value_type;
-        return std::all_of(e.cbegin(), e.cend(), [](const value_type& el) { return el; });
+        return detail::all_truthy(e, detail::has_dense_values<std::decay_t<E>>());
     }
 
     /**
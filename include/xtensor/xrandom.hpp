@@ -15,18 +15,28 @@
 #define XTENSOR_RANDOM_HPP
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <functional>
+#include <limits>
+#include <numeric>
 #include <random>
+#include <stdexcept>
+#include <unordered_set>
 #include <utility>
 #include <type_traits>
+#include <vector>
 
 #include <xtl/xspan.hpp>
 
 #include "xbuilder.hpp"
+#include "xexecution.hpp"
 #include "xgenerator.hpp"
 #include "xindex_view.hpp"
 #include "xtensor.hpp"
 #include "xtensor_config.hpp"
+#include "xtensor_simd.hpp"
 #include "xview.hpp"
 #include "xmath.hpp"
 
@@ -44,6 +54,105 @@ namespace xt
         default_engine_type& get_default_random_engine();
         void seed(seed_type seed);
 
+        /**
+         * @class philox4x32
+         * @brief Counter-based random number engine.
+         *
+         * Implements the Philox4x32-10 generator of Salmon et al., "Parallel
+         * random numbers: as easy as 1, 2, 3" (2011). Each block of four
+         * outputs is a bijection of a 128-bit counter keyed by the seed, so
+         * that any position of the sequence is computed in constant time. The
+         * upper half of the counter selects a stream, the lower half is the
+         * position in the stream.
+         *
+         * The random functions of this file draw the i-th element of the
+         * storage of a container from the i-th stream following the current
+         * one, and then move the engine past these streams. Therefore the drawn
+         * values only depend on the seed, the current stream and the position
+         * of the elements, and containers are filled in parallel with the
+         * current execution policy with results independent of the number of
+         * threads.
+         */
+        class philox4x32
+        {
+        public:
+
+            using result_type = std::uint32_t;
+            using seed_type = std::uint64_t;
+
+            static constexpr seed_type default_seed() noexcept;
+
+            explicit philox4x32(seed_type value = default_seed()) noexcept;
+
+            void seed(seed_type value) noexcept;
+
+            static constexpr result_type (min)() noexcept;
+            static constexpr result_type (max)() noexcept;
+
+            result_type operator()() noexcept;
+            void discard(unsigned long long n) noexcept;
+
+            std::uint64_t stream() const noexcept;
+            void set_stream(std::uint64_t stream) noexcept;
+
+            std::array<result_type, 4> stream_block(std::uint64_t stream) const noexcept;
+
+            bool operator==(const philox4x32& rhs) const noexcept;
+            bool operator!=(const philox4x32& rhs) const noexcept;
+
+        private:
+
+            using block_type = std::array<result_type, 4>;
+            using key_type = std::array<result_type, 2>;
+
+            static block_type generate_block(block_type counter, key_type key) noexcept;
+            void skip_blocks(std::uint64_t n) noexcept;
+
+            key_type m_key;
+            block_type m_counter;
+            block_type m_block;
+            std::size_t m_index;
+        };
+
+        /**
+         * @class alias_sampler
+         * @brief Sampler of indices from a discrete distribution.
+         *
+         * Builds the alias table of the distribution parametrized by the
+         * weights with Vose's algorithm, in linear time, so that each draw
+         * then takes constant time: an index is drawn uniformly, and replaced
+         * by its alias with the probability stored in the table. The table
+         * can be reused for any number of draws.
+         *
+         * @tparam T the floating point type of the probabilities
+         */
+        template <class T = double>
+        class alias_sampler
+        {
+        public:
+
+            using value_type = T;
+            using size_type = std::size_t;
+
+            template <class W>
+            explicit alias_sampler(const xexpression<W>& weights);
+
+            size_type size() const noexcept;
+            const xtensor<value_type, 1>& probabilities() const noexcept;
+            const xtensor<size_type, 1>& aliases() const noexcept;
+
+            template <class E>
+            size_type operator()(E& engine) const;
+
+            template <class E>
+            xtensor<size_type, 1> sample(size_type n, E& engine) const;
+
+        private:
+
+            xtensor<value_type, 1> m_probabilities;
+            xtensor<size_type, 1> m_aliases;
+        };
+
         template <class T, class S, class E = random::default_engine_type>
         auto rand(const S& shape, T lower = 0, T upper = 1,
                   E& engine = random::get_default_random_engine());
@@ -183,6 +292,10 @@ namespace xt
         std::enable_if_t<is_xexpression<std::decay_t<T>>::value, std::decay_t<T>>
         permutation(T&& e, E& engine = random::get_default_random_engine());
 
+        template <class T, class P>
+        auto permute_rows(const xexpression<T>& e, const xexpression<P>& perm)
+            -> temporary_type_t<T>;
+
         template <class T, class E = random::default_engine_type>
         xtensor<typename T::value_type, 1> choice(const xexpression<T>& e, std::size_t n, bool replace = true,
                                                   E& engine = random::get_default_random_engine());
@@ -196,6 +309,126 @@ namespace xt
 
     namespace detail
     {
+        template <class E, class = void>
+        struct is_counter_based_engine : std::false_type
+        {
+        };
+
+        template <class E>
+        struct is_counter_based_engine<E, void_t<decltype(std::declval<E&>().set_stream(std::declval<const E&>().stream()))>>
+            : std::true_type
+        {
+        };
+
+        /****************
+         * bulk sampler *
+         ****************/
+
+        // Samplers drawing each element from the first block of its stream of a
+        // philox4x32 engine, on simd batches of uniform numbers. Distributions
+        // without sampler are drawn with the engine positioned on the stream.
+        template <class D>
+        struct bulk_sampler
+        {
+        };
+
+        template <class T>
+        struct bulk_sampler<std::normal_distribution<T>>
+        {
+            // Box-Muller transform, the rejection loop of the ziggurat
+            // method does not vectorize
+            template <class B>
+            static B apply(const std::normal_distribution<T>& dist, const B& u1, const B& u2, const B& two_pi)
+            {
+                using math::cos;
+                using math::log;
+                using math::sqrt;
+                return dist.mean() + dist.stddev() * sqrt(T(-2) * log(u1)) * cos(two_pi * u2);
+            }
+        };
+
+        template <class T>
+        struct bulk_sampler<std::lognormal_distribution<T>>
+        {
+            template <class B>
+            static B apply(const std::lognormal_distribution<T>& dist, const B& u1, const B& u2, const B& two_pi)
+            {
+                using math::cos;
+                using math::exp;
+                using math::log;
+                using math::sqrt;
+                return exp(dist.m() + dist.s() * sqrt(T(-2) * log(u1)) * cos(two_pi * u2));
+            }
+        };
+
+        template <class T>
+        struct bulk_sampler<std::exponential_distribution<T>>
+        {
+            template <class B>
+            static B apply(const std::exponential_distribution<T>& dist, const B& u1, const B&, const B&)
+            {
+                using math::log;
+                return -log(u1) / dist.lambda();
+            }
+        };
+
+        template <class E, class D, class = void>
+        struct has_bulk_sampler : std::false_type
+        {
+        };
+
+        template <class D>
+        struct has_bulk_sampler<random::philox4x32, D,
+                                void_t<decltype(bulk_sampler<D>::apply(std::declval<const D&>(),
+                                                                       std::declval<const typename D::result_type&>(),
+                                                                       std::declval<const typename D::result_type&>(),
+                                                                       std::declval<const typename D::result_type&>()))>>
+            : std::is_floating_point<typename D::result_type>
+        {
+        };
+
+        // (k + offset) / 2^digits, k being made of the upper bits of (hi, lo)
+        template <class T>
+        inline T unit_interval(std::uint32_t hi, std::uint32_t lo, std::uint32_t offset) noexcept
+        {
+            constexpr int digits = (std::min)(std::numeric_limits<T>::digits, 64);
+            constexpr T high_scale = T(std::uint64_t(1) << (digits > 32 ? digits - 32 : 0));
+            constexpr T scale = digits > 32 ? T(4294967296.) * high_scale : T(std::uint64_t(1) << digits);
+            std::uint64_t bits = ((std::uint64_t(hi) << 32) | lo) >> (64 - digits);
+            return (static_cast<T>(bits) + static_cast<T>(offset)) / scale;
+        }
+
+        template <class D, class T>
+        inline void bulk_sample(const D& dist, const T* u1, const T* u2, T* out, std::false_type /*simd*/)
+        {
+            *out = bulk_sampler<D>::apply(dist, *u1, *u2, T(2) * numeric_constants<T>::PI);
+        }
+
+        template <class D, class T>
+        inline void bulk_sample(const D& dist, const T* u1, const T* u2, T* out, std::true_type /*simd*/)
+        {
+            auto two_pi = xt_simd::set_simd<T, T>(T(2) * numeric_constants<T>::PI);
+            auto res = bulk_sampler<D>::apply(dist, xt_simd::load_simd<T, T>(u1, xt_simd::unaligned_mode()),
+                                              xt_simd::load_simd<T, T>(u2, xt_simd::unaligned_mode()), two_pi);
+            xt_simd::store_simd<T, T>(out, res, xt_simd::unaligned_mode());
+        }
+
+        // samples n consecutive streams, n being the size of the simd batches of T;
+        // u1 lies in (0, 1] and u2 in [0, 1)
+        template <class D, class T>
+        inline void bulk_sample(const D& dist, const random::philox4x32& engine, std::uint64_t first_stream, T* out)
+        {
+            constexpr std::size_t simd_size = xt_simd::simd_traits<T>::size;
+            std::array<T, simd_size> u1, u2;
+            for (std::size_t i = 0; i < simd_size; ++i)
+            {
+                auto block = engine.stream_block(first_stream + i);
+                u1[i] = unit_interval<T>(block[0], block[1], 1);
+                u2[i] = unit_interval<T>(block[2], block[3], 0);
+            }
+            bulk_sample(dist, u1.data(), u2.data(), out, has_simd_type<T>());
+        }
+
         template <class T, class E, class D>
         struct random_impl
         {
@@ -209,13 +442,13 @@ namespace xt
             template <class... Args>
             inline value_type operator()(Args...) const
             {
-                return m_dist(m_engine);
+                return draw(is_counter_based_engine<E>());
             }
 
             template <class It>
             inline value_type element(It, It) const
             {
-                return m_dist(m_engine);
+                return draw(is_counter_based_engine<E>());
             }
 
             template <class EX>
@@ -223,17 +456,211 @@ namespace xt
             {
                 // Note: we're not going row/col major here
                 auto& ed = e.derived_cast();
-                for (auto&& el : ed.storage())
+                fill(ed.storage(), is_counter_based_engine<E>());
+            }
+
+        private:
+
+            inline value_type draw(std::false_type /*counter_based*/) const
+            {
+                return m_dist(m_engine);
+            }
+
+            // each element is drawn from its own stream
+            inline value_type draw(std::true_type /*counter_based*/) const
+            {
+                auto stream = m_engine.stream();
+                value_type res = draw_stream(stream, has_bulk_sampler<E, D>());
+                m_engine.set_stream(stream + 1);
+                return res;
+            }
+
+            inline value_type draw_stream(std::uint64_t, std::false_type /*bulk*/) const
+            {
+                m_dist.reset();
+                return m_dist(m_engine);
+            }
+
+            // the element is computed in a batch of identical streams, so that it
+            // matches the elements of the same stream in a bulk fill
+            inline value_type draw_stream(std::uint64_t stream, std::true_type /*bulk*/) const
+            {
+                using result_type = typename D::result_type;
+                std::array<result_type, xt_simd::simd_traits<result_type>::size> u1, u2, res;
+                auto block = m_engine.stream_block(stream);
+                u1.fill(unit_interval<result_type>(block[0], block[1], 1));
+                u2.fill(unit_interval<result_type>(block[2], block[3], 0));
+                bulk_sample(m_dist, u1.data(), u2.data(), res.data(), has_simd_type<result_type>());
+                return static_cast<value_type>(res[0]);
+            }
+
+            template <class ST>
+            inline void fill(ST& storage, std::false_type /*counter_based*/) const
+            {
+                for (auto&& el : storage)
                 {
                     el = m_dist(m_engine);
                 }
             }
 
-        private:
+            template <class ST>
+            inline void fill(ST& storage, std::true_type /*counter_based*/) const
+            {
+                const auto first_stream = m_engine.stream();
+                fill_streams(storage, first_stream, has_bulk_sampler<E, D>());
+                m_engine.set_stream(first_stream + storage.size());
+            }
+
+            template <class ST>
+            inline void fill_streams(ST& storage, std::uint64_t first_stream, std::false_type /*bulk*/) const
+            {
+                execution::parallel_for(execution::default_policy(), 0, storage.size(),
+                                        [&](std::size_t first, std::size_t last)
+                {
+                    E engine = m_engine;
+                    D dist = m_dist;
+                    for (std::size_t i = first; i < last; ++i)
+                    {
+                        engine.set_stream(first_stream + i);
+                        dist.reset();
+                        storage[i] = dist(engine);
+                    }
+                });
+            }
+
+            template <class ST>
+            inline void fill_streams(ST& storage, std::uint64_t first_stream, std::true_type /*bulk*/) const
+            {
+                using result_type = typename D::result_type;
+                constexpr std::size_t simd_size = xt_simd::simd_traits<result_type>::size;
+                const std::size_t size = storage.size();
+                const std::size_t nb_batches = (size + simd_size - 1) / simd_size;
+                const auto& policy = execution::default_policy();
+                execution::parallel_for(policy.with_grain_size((std::max)(policy.grain_size() / simd_size, std::size_t(1))),
+                                        0, nb_batches, [&](std::size_t first, std::size_t last)
+                {
+                    std::array<result_type, simd_size> res;
+                    for (std::size_t b = first; b < last; ++b)
+                    {
+                        std::size_t offset = b * simd_size;
+                        bulk_sample(m_dist, m_engine, first_stream + offset, res.data());
+                        std::size_t count = (std::min)(simd_size, size - offset);
+                        for (std::size_t i = 0; i < count; ++i)
+                        {
+                            storage[offset + i] = static_cast<value_type>(res[i]);
+                        }
+                    }
+                });
+            }
 
             E& m_engine;
             mutable D m_dist;
         };
+
+        template <class T>
+        inline void swap_rows(T* lhs, T* rhs, std::size_t size, std::false_type /*simd*/)
+        {
+            std::swap_ranges(lhs, lhs + size, rhs);
+        }
+
+        template <class T>
+        inline void swap_rows(T* lhs, T* rhs, std::size_t size, std::true_type /*simd*/)
+        {
+            constexpr std::size_t simd_size = xt_simd::simd_traits<T>::size;
+            std::size_t align_end = size - size % simd_size;
+            for (std::size_t i = 0; i < align_end; i += simd_size)
+            {
+                auto lhs_batch = xt_simd::load_simd<T, T>(lhs + i, xt_simd::unaligned_mode());
+                auto rhs_batch = xt_simd::load_simd<T, T>(rhs + i, xt_simd::unaligned_mode());
+                xt_simd::store_simd<T, T>(lhs + i, rhs_batch, xt_simd::unaligned_mode());
+                xt_simd::store_simd<T, T>(rhs + i, lhs_batch, xt_simd::unaligned_mode());
+            }
+            std::swap_ranges(lhs + align_end, lhs + size, rhs + align_end);
+        }
+
+        template <class T, class E>
+        inline void shuffle_rows(T& de, E& engine, std::false_type /*has_data_interface*/)
+        {
+            using size_type = typename T::size_type;
+            decltype(auto) buf = empty_like(view(de, 0));
+
+            for (size_type i = de.shape()[0] - 1; i > 0; --i)
+            {
+                std::uniform_int_distribution<size_type> dist(0, i);
+                size_type j = dist(engine);
+
+                buf = view(de, j);
+                view(de, j) = view(de, i);
+                view(de, i) = buf;
+            }
+        }
+
+        // The rows of contiguous row-major containers are swapped in place,
+        // with the same draws as the generic implementation.
+        template <class T, class E>
+        inline void shuffle_rows(T& de, E& engine, std::true_type /*has_data_interface*/)
+        {
+            if (!(de.is_contiguous() && de.layout() == layout_type::row_major))
+            {
+                shuffle_rows(de, engine, std::false_type());
+                return;
+            }
+            if (de.shape()[0] == 0)
+            {
+                return;
+            }
+
+            using size_type = typename T::size_type;
+            using value_type = typename T::value_type;
+            const size_type row_size = de.size() / de.shape()[0];
+            auto* data = de.data() + de.data_offset();
+            for (size_type i = de.shape()[0] - 1; i > 0; --i)
+            {
+                std::uniform_int_distribution<size_type> dist(0, i);
+                size_type j = dist(engine);
+                if (i != j)
+                {
+                    swap_rows(data + i * row_size, data + j * row_size, row_size, has_simd_type<value_type>());
+                }
+            }
+        }
+
+        template <class T, class R>
+        inline void gather_rows(const T& de, const std::vector<std::size_t>& rows, R& res, std::false_type /*has_data_interface*/)
+        {
+            for (std::size_t k = 0; k < rows.size(); ++k)
+            {
+                view(res, k) = view(de, rows[k]);
+            }
+        }
+
+        // Rows of contiguous row-major containers are copied with blocks of
+        // consecutive result rows distributed over the threads.
+        template <class T, class R>
+        inline void gather_rows(const T& de, const std::vector<std::size_t>& rows, R& res, std::true_type /*has_data_interface*/)
+        {
+            if (!(de.is_contiguous() && de.layout() == layout_type::row_major && res.layout() == layout_type::row_major))
+            {
+                gather_rows(de, rows, res, std::false_type());
+                return;
+            }
+            if (rows.empty())
+            {
+                return;
+            }
+
+            const std::size_t row_size = de.size() / de.shape()[0];
+            const auto* src = de.data() + de.data_offset();
+            auto* dst = res.data();
+            execution::parallel_for(execution::default_policy(), 0, rows.size(),
+                                    [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t k = first; k < last; ++k)
+                {
+                    std::copy_n(src + rows[k] * row_size, row_size, dst + k * row_size);
+                }
+            });
+        }
     }
 
     namespace random
@@ -256,6 +683,264 @@ namespace xt
             get_default_random_engine().seed(seed);
         }
 
+        /*****************************
+         * philox4x32 implementation *
+         *****************************/
+
+        constexpr auto philox4x32::default_seed() noexcept -> seed_type
+        {
+            return 20111115u;
+        }
+
+        /**
+         * Builds an engine keyed by @p value, positioned at the beginning of
+         * the first stream.
+         * @param value The seed
+         */
+        inline philox4x32::philox4x32(seed_type value) noexcept
+            : m_key(), m_counter(), m_block(), m_index(0)
+        {
+            seed(value);
+        }
+
+        /**
+         * Resets the key of the engine to @p value and moves it to the
+         * beginning of the first stream.
+         * @param value The seed
+         */
+        inline void philox4x32::seed(seed_type value) noexcept
+        {
+            m_key = {{static_cast<result_type>(value), static_cast<result_type>(value >> 32)}};
+            set_stream(0);
+        }
+
+        constexpr auto philox4x32::min() noexcept -> result_type
+        {
+            return 0;
+        }
+
+        constexpr auto philox4x32::max() noexcept -> result_type
+        {
+            return (std::numeric_limits<result_type>::max)();
+        }
+
+        inline auto philox4x32::operator()() noexcept -> result_type
+        {
+            if (m_index == m_block.size())
+            {
+                m_block = generate_block(m_counter, m_key);
+                skip_blocks(1);
+                m_index = 0;
+            }
+            return m_block[m_index++];
+        }
+
+        /**
+         * Advances the engine by @p n outputs in constant time.
+         */
+        inline void philox4x32::discard(unsigned long long n) noexcept
+        {
+            for (; n != 0 && m_index != m_block.size(); --n)
+            {
+                ++m_index;
+            }
+            skip_blocks(static_cast<std::uint64_t>(n / m_block.size()));
+            for (n %= m_block.size(); n != 0; --n)
+            {
+                (*this)();
+            }
+        }
+
+        /**
+         * Returns the index of the current stream.
+         */
+        inline std::uint64_t philox4x32::stream() const noexcept
+        {
+            return (std::uint64_t(m_counter[3]) << 32) | m_counter[2];
+        }
+
+        /**
+         * Moves the engine to the beginning of the stream with index @p stream.
+         */
+        inline void philox4x32::set_stream(std::uint64_t stream) noexcept
+        {
+            m_counter = {{0, 0, static_cast<result_type>(stream), static_cast<result_type>(stream >> 32)}};
+            m_index = m_block.size();
+        }
+
+        /**
+         * Returns the first four outputs of the stream with index @p stream,
+         * without changing the state of the engine.
+         */
+        inline auto philox4x32::stream_block(std::uint64_t stream) const noexcept -> std::array<result_type, 4>
+        {
+            return generate_block({{0, 0, static_cast<result_type>(stream), static_cast<result_type>(stream >> 32)}}, m_key);
+        }
+
+        inline bool philox4x32::operator==(const philox4x32& rhs) const noexcept
+        {
+            return m_key == rhs.m_key && m_counter == rhs.m_counter && m_index == rhs.m_index &&
+                   (m_index == m_block.size() || m_block == rhs.m_block);
+        }
+
+        inline bool philox4x32::operator!=(const philox4x32& rhs) const noexcept
+        {
+            return !(*this == rhs);
+        }
+
+        inline auto philox4x32::generate_block(block_type counter, key_type key) noexcept -> block_type
+        {
+            constexpr std::uint64_t multiplier0 = 0xD2511F53;
+            constexpr std::uint64_t multiplier1 = 0xCD9E8D57;
+            constexpr result_type weyl0 = 0x9E3779B9;
+            constexpr result_type weyl1 = 0xBB67AE85;
+            for (std::size_t round = 0; round < 10; ++round)
+            {
+                std::uint64_t product0 = multiplier0 * counter[0];
+                std::uint64_t product1 = multiplier1 * counter[2];
+                counter = {{static_cast<result_type>(product1 >> 32) ^ counter[1] ^ key[0],
+                            static_cast<result_type>(product1),
+                            static_cast<result_type>(product0 >> 32) ^ counter[3] ^ key[1],
+                            static_cast<result_type>(product0)}};
+                key[0] += weyl0;
+                key[1] += weyl1;
+            }
+            return counter;
+        }
+
+        // moves the position in the stream by n blocks, wrapping in the stream
+        inline void philox4x32::skip_blocks(std::uint64_t n) noexcept
+        {
+            std::uint64_t position = ((std::uint64_t(m_counter[1]) << 32) | m_counter[0]) + n;
+            m_counter[0] = static_cast<result_type>(position);
+            m_counter[1] = static_cast<result_type>(position >> 32);
+        }
+
+        /********************************
+         * alias_sampler implementation *
+         ********************************/
+
+        /**
+         * Builds the alias table of the distribution where the probability of
+         * index i is ``weights[i] / sum(weights)``.
+         * @param weights 1D expression of nonnegative weights, with a positive sum
+         */
+        template <class T>
+        template <class W>
+        inline alias_sampler<T>::alias_sampler(const xexpression<W>& weights)
+        {
+            const auto& dweights = weights.derived_cast();
+            XTENSOR_ASSERT((dweights.dimension() == 1));
+            XTENSOR_ASSERT(xt::all(dweights >= 0));
+
+            const size_type n = dweights.size();
+            xtensor<value_type, 1> scaled = dweights;
+            value_type total = std::accumulate(scaled.cbegin(), scaled.cend(), value_type(0));
+            if (!(total > value_type(0)) || !std::isfinite(total))
+            {
+                XTENSOR_THROW(std::runtime_error, "alias_sampler: the weights must have a positive finite sum");
+            }
+            scaled *= static_cast<value_type>(n) / total;
+
+            m_probabilities.resize({n});
+            m_aliases.resize({n});
+            std::vector<size_type> underfull, overfull;
+            for (size_type i = 0; i < n; ++i)
+            {
+                (scaled(i) < value_type(1) ? underfull : overfull).push_back(i);
+            }
+
+            while (!underfull.empty() && !overfull.empty())
+            {
+                size_type s = underfull.back();
+                size_type l = overfull.back();
+                underfull.pop_back();
+                m_probabilities(s) = scaled(s);
+                m_aliases(s) = l;
+                scaled(l) = (scaled(l) + scaled(s)) - value_type(1);
+                if (scaled(l) < value_type(1))
+                {
+                    overfull.pop_back();
+                    underfull.push_back(l);
+                }
+            }
+
+            // the remaining entries only differ from 1 by rounding errors,
+            // except those of null weights which must never be drawn
+            size_type fallback = static_cast<size_type>(std::max_element(dweights.cbegin(), dweights.cend()) - dweights.cbegin());
+            for (auto* remaining : {&underfull, &overfull})
+            {
+                for (size_type i : *remaining)
+                {
+                    bool drawn = dweights(i) > 0;
+                    m_probabilities(i) = drawn ? value_type(1) : value_type(0);
+                    m_aliases(i) = drawn ? i : fallback;
+                }
+            }
+        }
+
+        /**
+         * Returns the number of indices of the distribution.
+         */
+        template <class T>
+        inline auto alias_sampler<T>::size() const noexcept -> size_type
+        {
+            return m_probabilities.size();
+        }
+
+        /**
+         * Returns the probabilities to keep the uniformly drawn indices.
+         */
+        template <class T>
+        inline auto alias_sampler<T>::probabilities() const noexcept -> const xtensor<value_type, 1>&
+        {
+            return m_probabilities;
+        }
+
+        /**
+         * Returns the aliases replacing the uniformly drawn indices.
+         */
+        template <class T>
+        inline auto alias_sampler<T>::aliases() const noexcept -> const xtensor<size_type, 1>&
+        {
+            return m_aliases;
+        }
+
+        /**
+         * Draws an index.
+         * @param engine random number engine
+         */
+        template <class T>
+        template <class E>
+        inline auto alias_sampler<T>::operator()(E& engine) const -> size_type
+        {
+            std::uniform_int_distribution<size_type> index_dist(0, size() - 1);
+            std::uniform_real_distribution<value_type> prob_dist(0, 1);
+            size_type i = index_dist(engine);
+            return prob_dist(engine) < m_probabilities(i) ? i : m_aliases(i);
+        }
+
+        /**
+         * Draws @p n indices.
+         * @param n number of indices to draw
+         * @param engine random number engine
+         * @return 1D xtensor of the drawn indices
+         */
+        template <class T>
+        template <class E>
+        inline auto alias_sampler<T>::sample(size_type n, E& engine) const -> xtensor<size_type, 1>
+        {
+            std::uniform_int_distribution<size_type> index_dist(0, size() - 1);
+            std::uniform_real_distribution<value_type> prob_dist(0, 1);
+            xtensor<size_type, 1> res = xtensor<size_type, 1>::from_shape({n});
+            for (auto& x : res)
+            {
+                size_type i = index_dist(engine);
+                x = prob_dist(engine) < m_probabilities(i) ? i : m_aliases(i);
+            }
+            return res;
+        }
+
         /**
          * xexpression with specified @p shape containing uniformly distributed random numbers
          * in the interval from @p lower to @p upper, excluding upper.
@@ -678,6 +1363,7 @@ namespace xt
         /**
          * Randomly shuffle elements inplace in xcontainer along first axis.
          * The order of sub-arrays is changed but their contents remain the same.
+         * The sub-arrays of contiguous row-major containers are swapped in place.
          *
          * @param e xcontainer to shuffle inplace
          * @param engine random number engine
@@ -703,18 +1389,7 @@ namespace xt
             }
             else
             {
-                using size_type = typename T::size_type;
-                decltype(auto) buf = empty_like(view(de, 0));
-
-                for (size_type i = de.shape()[0] - 1; i > 0; --i)
-                {
-                    std::uniform_int_distribution<size_type> dist(0, i);
-                    size_type j = dist(engine);
-
-                    buf = view(de, j);
-                    view(de, j) = view(de, i);
-                    view(de, i) = buf;
-                }
+                detail::shuffle_rows(de, engine, has_data_interface<T>());
             }
         }
 
@@ -752,8 +1427,57 @@ namespace xt
         }
         /// @endcond
 
+        /**
+         * Gathers the sub-arrays of an expression along its first axis: the
+         * k-th sub-array of the result is the ``perm[k]``-th sub-array of @p e.
+         * The sub-arrays of contiguous row-major containers are copied in
+         * blocks distributed over the threads of the default execution policy.
+         *
+         * @param e expression whose sub-arrays are gathered
+         * @param perm 1D expression of indices along the first axis, for instance
+         *        a permutation
+         *
+         * @return container of the gathered sub-arrays
+         */
+        template <class T, class P>
+        inline auto permute_rows(const xexpression<T>& e, const xexpression<P>& perm)
+            -> temporary_type_t<T>
+        {
+            using result_type = temporary_type_t<T>;
+            using shape_type = typename result_type::shape_type;
+            const auto& de = e.derived_cast();
+            const auto& dperm = perm.derived_cast();
+            XTENSOR_ASSERT((dperm.dimension() == 1));
+            if (de.dimension() == 0)
+            {
+                XTENSOR_THROW(std::runtime_error, "permute_rows: the expression must have at least one dimension");
+            }
+
+            const std::size_t nb_rows = de.shape()[0];
+            std::vector<std::size_t> rows;
+            rows.reserve(dperm.size());
+            for (const auto& row : dperm)
+            {
+                std::size_t index = static_cast<std::size_t>(row);
+                if (index >= nb_rows)
+                {
+                    XTENSOR_THROW(std::out_of_range, "permute_rows: index out of bounds");
+                }
+                rows.push_back(index);
+            }
+
+            shape_type shape = xtl::make_sequence<shape_type>(de.dimension(), 0);
+            std::copy(de.shape().cbegin(), de.shape().cend(), shape.begin());
+            shape[0] = rows.size();
+            result_type res = result_type::from_shape(shape);
+            detail::gather_rows(de, rows, res, has_data_interface<T>());
+            return res;
+        }
+
         /**
          * Randomly select n unique elements from xexpression e.
+         * When few elements are sampled without replacement, they are drawn with Floyd's
+         * algorithm, otherwise with reservoir sampling.
          * Note: this function makes a copy of your data, and only 1D data is accepted.
          *
          * @param e expression to sample from
@@ -782,6 +1506,30 @@ namespace xt
                     result[i] = de.storage()[dist(engine)];
                 }
             }
+            else if (4 * n <= de.size())
+            {
+                // Floyd's algorithm draws a subset of n indices with n draws,
+                // which is then shuffled
+                std::unordered_set<size_type> selected(2 * n);
+                std::vector<size_type> indices;
+                indices.reserve(n);
+                for (size_type j = de.size() - n; j < de.size(); ++j)
+                {
+                    size_type t = std::uniform_int_distribution<size_type>(0, j)(engine);
+                    size_type idx = selected.count(t) ? j : t;
+                    selected.insert(idx);
+                    indices.push_back(idx);
+                }
+                for (size_type i = n; i > 1; --i)
+                {
+                    size_type j = std::uniform_int_distribution<size_type>(0, i - 1)(engine);
+                    std::swap(indices[i - 1], indices[j]);
+                }
+                for (size_type i = 0; i < n; ++i)
+                {
+                    result[i] = de.storage()[indices[i]];
+                }
+            }
             else
             {
                 // Naive resevoir sampling without weighting:
@@ -809,7 +1557,7 @@ namespace xt
          * Without replacement, this only describes the probability of the first sample element.
          * In successive samples, the weight of items already sampled is assumed to be zero.
          *
-         * For weighted random sampling with replacement, binary search with cumulative weights alogrithm is used.
+         * For weighted random sampling with replacement, the alias method is used, see alias_sampler.
          * For weighted random sampling without replacement, the algorithm used is the exponential sort from
          * [Efraimidis and Spirakis](https://doi.org/10.1016/j.ipl.2005.11.003) (2006) with the ``weight / randexp(1)``
          * [trick](https://web.archive.org/web/20201021162211/https://krlmlr.github.io/wrswoR/) from Kirill Müller.
@@ -846,18 +1594,9 @@ namespace xt
 
             if (replace)
             {
-                // Sample u uniformly in the range [0, sum(weights)[
-                // The index idx of the sampled element is such that weight_cumul[idx - 1] <= u < weight_cumul[idx].
-                // Where weight_cumul[-1] is implicitly 0, as the empty sum.
-                const auto wc = eval(cumsum(dweights));
-                std::uniform_real_distribution<weight_type> weight_dist{0, wc[wc.size() - 1]};
-                for(auto& x : result)
-                {
-                    const auto u = weight_dist(engine);
-                    const auto idx = static_cast<size_type>(std::upper_bound(wc.cbegin(), wc.cend(), u) - wc.cbegin());
-                    x = de[idx];
-                }
-
+                alias_sampler<weight_type> sampler(dweights);
+                const auto indices = sampler.sample(n, engine);
+                std::transform(indices.cbegin(), indices.cend(), result.begin(), [&de](size_type idx) { return de[idx]; });
             }
             else
             {
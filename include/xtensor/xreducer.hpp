@@ -11,9 +11,11 @@
 #define XTENSOR_REDUCER_HPP
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <initializer_list>
 #include <iterator>
+#include <numeric>
 #include <stdexcept>
 #include <tuple>
 #include <type_traits>
@@ -25,10 +27,13 @@
 #include "xaccessible.hpp"
 #include "xbuilder.hpp"
 #include "xeval.hpp"
+#include "xexecution.hpp"
 #include "xexpression.hpp"
 #include "xgenerator.hpp"
 #include "xiterable.hpp"
+#include "xstorage.hpp"
 #include "xtensor_config.hpp"
+#include "xtensor_simd.hpp"
 #include "xutils.hpp"
 
 namespace xt
@@ -43,6 +48,25 @@ namespace xt
     struct keep_dims_type : xt::detail::option_base {};
     constexpr auto keep_dims = std::tuple<keep_dims_type>{};
 
+    /**
+     * Summation algorithms for sums and the reducers based on them (mean,
+     * variance, ...). ``naive`` accumulates the values in sequence, ``pairwise``
+     * reduces blocks and merges them pairwise, with an O(log(n)) error growth,
+     * and ``kahan`` uses compensated summation, with an error independent of
+     * the number of elements. Requesting ``kahan`` on a reducer that is not a
+     * floating point sum, or ``pairwise`` on a reducer whose partial results
+     * cannot be merged, falls back to ``naive``.
+     */
+    namespace summation
+    {
+        struct naive_type : xt::detail::option_base {};
+        constexpr auto naive = std::tuple<naive_type>{};
+        struct pairwise_type : xt::detail::option_base {};
+        constexpr auto pairwise = std::tuple<pairwise_type>{};
+        struct kahan_type : xt::detail::option_base {};
+        constexpr auto kahan = std::tuple<kahan_type>{};
+    }
+
     template <class T = double>
     struct xinitial : xt::detail::option_base
     {
@@ -133,6 +157,12 @@ namespace xt
                                              std::true_type,
                                              std::false_type>;
 
+        using summation = std::conditional_t<tuple_idx_of<xt::summation::kahan_type, d_t>::value != -1,
+                                             xt::summation::kahan_type,
+                                             std::conditional_t<tuple_idx_of<xt::summation::pairwise_type, d_t>::value != -1,
+                                                                xt::summation::pairwise_type,
+                                                                xt::summation::naive_type>>;
+
         constexpr static bool has_initial_value = initial_val_idx != std::tuple_size<d_t>::value;
 
         R initial_value;
@@ -260,6 +290,546 @@ namespace xt
         }
     }
 
+    /**
+     * Traits class telling whether a reducing functor is associative and can
+     * therefore be used to merge partial results of a reduction. Immediate
+     * complete reductions are split into independent partial reductions (that
+     * may be vectorized and run in parallel) when the reducing functor satisfies
+     * this trait, or when the reducer provides its own merging functor.
+     */
+    template <class F>
+    struct is_associative_reducer : std::false_type
+    {
+    };
+
+    namespace detail
+    {
+        template <class F>
+        struct allows_split_reduction
+            : xtl::disjunction<xtl::negation<std::is_same<typename F::reduce_functor_type, typename F::merge_functor_type>>,
+                               is_associative_reducer<typename F::reduce_functor_type>>
+        {
+        };
+
+        template <class F, class B, class = void>
+        struct has_reduce_simd_apply : std::false_type
+        {
+        };
+
+        template <class F, class B>
+        struct has_reduce_simd_apply<F, B, void_t<decltype(std::declval<const F&>().simd_apply(std::declval<B>(), std::declval<B>()))>>
+            : std::true_type
+        {
+        };
+
+        template <class S, class R, class RF>
+        struct use_simd_reduction
+            : xtl::conjunction<std::is_same<typename S::value_type, R>,
+                               std::is_arithmetic<R>,
+                               has_simd_type<R>,
+                               xtl::negation<forbid_simd<S>>,
+                               has_reduce_simd_apply<RF, xt_simd::simd_type<R>>>
+        {
+        };
+
+        /**
+         * Summation algorithm actually used by a reducer: compensated summation
+         * only applies to floating point sums, pairwise summation to reducers
+         * whose partial results can be merged. Compensated summation is also
+         * used for sums along outer axes when pairwise summation is requested,
+         * since the rows are then accumulated vertically.
+         */
+        template <class F, class R, class S>
+        struct summation_algorithm
+        {
+            static constexpr bool is_sum = std::is_same<std::decay_t<typename F::reduce_functor_type>, plus>::value &&
+                                           std::is_floating_point<R>::value;
+            static constexpr bool kahan = is_sum && std::is_same<S, summation::kahan_type>::value;
+            static constexpr bool pairwise = allows_split_reduction<F>::value && std::is_same<S, summation::pairwise_type>::value;
+
+            using type = std::conditional_t<kahan,
+                                            summation::kahan_type,
+                                            std::conditional_t<pairwise, summation::pairwise_type, summation::naive_type>>;
+            using compensated_columns = std::integral_constant<bool, is_sum && !std::is_same<S, summation::naive_type>::value>;
+        };
+
+        template <class F, class R, class S>
+        using summation_algorithm_t = typename summation_algorithm<F, R, S>::type;
+
+        // Number of independent accumulators used in a block: breaking the
+        // dependency chain of the accumulation keeps the pipeline busy.
+        constexpr std::size_t reduce_scalar_lanes = 8;
+        constexpr std::size_t reduce_simd_lanes = 4;
+        // Number of elements reduced sequentially by pairwise summation
+        constexpr std::size_t pairwise_block_size = 16 * reduce_scalar_lanes;
+
+        template <class R, class MF>
+        inline R merge_pairwise(MF& merge_fct, R* first, std::size_t size)
+        {
+            while (size > 1)
+            {
+                std::size_t half = size / 2;
+                for (std::size_t i = 0; i < half; ++i)
+                {
+                    first[i] = merge_fct(first[2 * i], first[2 * i + 1]);
+                }
+                if (size % 2 != 0)
+                {
+                    first[half] = first[size - 1];
+                }
+                size -= half;
+            }
+            return first[0];
+        }
+
+        template <class T>
+        struct kahan_accumulator
+        {
+            T sum;
+            T compensation;
+
+            void add(const T& value) noexcept
+            {
+                T y = value - compensation;
+                T t = sum + y;
+                compensation = (t - sum) - y;
+                sum = t;
+            }
+
+            T value() const noexcept
+            {
+                return sum - compensation;
+            }
+        };
+
+        struct kahan_merge
+        {
+            template <class T>
+            kahan_accumulator<T> operator()(kahan_accumulator<T> lhs, const kahan_accumulator<T>& rhs) const noexcept
+            {
+                lhs.add(rhs.sum);
+                lhs.add(-rhs.compensation);
+                return lhs;
+            }
+        };
+
+        /**
+         * Merges partial results pushed in sequence as if they were reduced
+         * pairwise, using a stack of O(log(n)) partial results.
+         */
+        template <class R, class MF>
+        class pairwise_cascade
+        {
+        public:
+
+            explicit pairwise_cascade(const MF& merge_fct)
+                : m_merge(merge_fct), m_levels(), m_count(0)
+            {
+            }
+
+            void push(R value)
+            {
+                std::size_t level = 0;
+                for (; (m_count >> level) & std::size_t(1); ++level)
+                {
+                    value = m_merge(m_levels[level], value);
+                }
+                m_levels[level] = std::move(value);
+                ++m_count;
+            }
+
+            R value(const R& init) const
+            {
+                R res = init;
+                bool empty = true;
+                for (std::size_t level = m_levels.size(); level-- > 0;)
+                {
+                    if ((m_count >> level) & std::size_t(1))
+                    {
+                        if (empty)
+                        {
+                            res = m_levels[level];
+                            empty = false;
+                        }
+                        else
+                        {
+                            res = m_merge(res, m_levels[level]);
+                        }
+                    }
+                }
+                return res;
+            }
+
+        private:
+
+            const MF& m_merge;
+            std::array<R, 8 * sizeof(std::size_t)> m_levels;
+            std::size_t m_count;
+        };
+
+        template <class R, class RF, class MF, class It>
+        inline R reduce_block(RF& reduce_fct, MF& merge_fct, const R& init,
+                              It first, std::size_t size, std::false_type /*simd*/)
+        {
+            std::array<R, reduce_scalar_lanes> acc;
+            acc.fill(init);
+            std::size_t i = 0;
+            for (; i + reduce_scalar_lanes <= size; i += reduce_scalar_lanes)
+            {
+                for (std::size_t j = 0; j < reduce_scalar_lanes; ++j)
+                {
+                    acc[j] = reduce_fct(acc[j], first[static_cast<std::ptrdiff_t>(i + j)]);
+                }
+            }
+            for (std::size_t j = 0; i < size; ++i, ++j)
+            {
+                acc[j] = reduce_fct(acc[j], first[static_cast<std::ptrdiff_t>(i)]);
+            }
+            return merge_pairwise(merge_fct, acc.data(), reduce_scalar_lanes);
+        }
+
+        template <class R, class RF, class MF>
+        inline R reduce_block(RF& reduce_fct, MF& merge_fct, const R& init,
+                              const R* first, std::size_t size, std::true_type /*simd*/)
+        {
+            using batch_type = xt_simd::simd_type<R>;
+            constexpr std::size_t simd_size = xt_simd::simd_traits<R>::size;
+            constexpr std::size_t stride = simd_size * reduce_simd_lanes;
+
+            std::array<batch_type, reduce_simd_lanes> acc;
+            acc.fill(xt_simd::set_simd<R, R>(init));
+            std::size_t i = 0;
+            for (; i + stride <= size; i += stride)
+            {
+                for (std::size_t j = 0; j < reduce_simd_lanes; ++j)
+                {
+                    acc[j] = reduce_fct.simd_apply(acc[j], xt_simd::load_simd<R, R>(first + i + j * simd_size,
+                                                                                    xt_simd::unaligned_mode()));
+                }
+            }
+            for (; i + simd_size <= size; i += simd_size)
+            {
+                acc[0] = reduce_fct.simd_apply(acc[0], xt_simd::load_simd<R, R>(first + i, xt_simd::unaligned_mode()));
+            }
+
+            std::array<R, stride> lanes;
+            for (std::size_t j = 0; j < reduce_simd_lanes; ++j)
+            {
+                xt_simd::store_simd<R, R>(lanes.data() + j * simd_size, acc[j], xt_simd::unaligned_mode());
+            }
+            for (std::size_t j = 0; i < size; ++i, ++j)
+            {
+                lanes[j] = reduce_fct(lanes[j], first[i]);
+            }
+            return merge_pairwise(merge_fct, lanes.data(), stride);
+        }
+
+        template <class R, class It>
+        inline kahan_accumulator<R> kahan_block(const R& init, It first, std::size_t size, std::false_type /*simd*/)
+        {
+            std::array<kahan_accumulator<R>, reduce_scalar_lanes> acc;
+            acc.fill(kahan_accumulator<R>{R(0), R(0)});
+            acc[0].sum = init;
+            std::size_t i = 0;
+            for (; i + reduce_scalar_lanes <= size; i += reduce_scalar_lanes)
+            {
+                for (std::size_t j = 0; j < reduce_scalar_lanes; ++j)
+                {
+                    acc[j].add(static_cast<R>(first[static_cast<std::ptrdiff_t>(i + j)]));
+                }
+            }
+            for (std::size_t j = 0; i < size; ++i, ++j)
+            {
+                acc[j].add(static_cast<R>(first[static_cast<std::ptrdiff_t>(i)]));
+            }
+            kahan_merge merge_fct;
+            return merge_pairwise(merge_fct, acc.data(), reduce_scalar_lanes);
+        }
+
+        template <class R>
+        inline kahan_accumulator<R> kahan_block(const R& init, const R* first, std::size_t size, std::true_type /*simd*/)
+        {
+            using batch_type = xt_simd::simd_type<R>;
+            constexpr std::size_t simd_size = xt_simd::simd_traits<R>::size;
+            constexpr std::size_t stride = simd_size * reduce_simd_lanes;
+
+            std::array<batch_type, reduce_simd_lanes> sum;
+            std::array<batch_type, reduce_simd_lanes> compensation;
+            sum.fill(xt_simd::set_simd<R, R>(R(0)));
+            compensation.fill(xt_simd::set_simd<R, R>(R(0)));
+            std::size_t i = 0;
+            for (; i + stride <= size; i += stride)
+            {
+                for (std::size_t j = 0; j < reduce_simd_lanes; ++j)
+                {
+                    batch_type y = xt_simd::load_simd<R, R>(first + i + j * simd_size, xt_simd::unaligned_mode()) - compensation[j];
+                    batch_type t = sum[j] + y;
+                    compensation[j] = (t - sum[j]) - y;
+                    sum[j] = t;
+                }
+            }
+
+            std::array<R, stride> sum_lanes;
+            std::array<R, stride> compensation_lanes;
+            for (std::size_t j = 0; j < reduce_simd_lanes; ++j)
+            {
+                xt_simd::store_simd<R, R>(sum_lanes.data() + j * simd_size, sum[j], xt_simd::unaligned_mode());
+                xt_simd::store_simd<R, R>(compensation_lanes.data() + j * simd_size, compensation[j], xt_simd::unaligned_mode());
+            }
+            std::array<kahan_accumulator<R>, stride> acc;
+            for (std::size_t j = 0; j < stride; ++j)
+            {
+                acc[j] = kahan_accumulator<R>{sum_lanes[j], compensation_lanes[j]};
+            }
+            acc[0].add(init);
+            for (std::size_t j = 0; i < size; ++i, ++j)
+            {
+                acc[j].add(first[i]);
+            }
+            kahan_merge merge_fct;
+            return merge_pairwise(merge_fct, acc.data(), stride);
+        }
+
+        template <class R>
+        constexpr std::size_t pairwise_leaf_size(std::false_type /*simd*/)
+        {
+            return pairwise_block_size;
+        }
+
+        template <class R>
+        constexpr std::size_t pairwise_leaf_size(std::true_type /*simd*/)
+        {
+            return 16 * reduce_simd_lanes * xt_simd::simd_traits<R>::size;
+        }
+
+        template <class R, class RF, class MF, class It, class S>
+        inline R reduce_pairwise(RF& reduce_fct, MF& merge_fct, const R& init, It first, std::size_t size, S simd)
+        {
+            if (size <= pairwise_leaf_size<R>(simd))
+            {
+                return reduce_block(reduce_fct, merge_fct, init, first, size, simd);
+            }
+            std::size_t half = size / 2;
+            half -= half % reduce_scalar_lanes;
+            R lhs = reduce_pairwise(reduce_fct, merge_fct, init, first, half, simd);
+            R rhs = reduce_pairwise(reduce_fct, merge_fct, init, first + static_cast<std::ptrdiff_t>(half), size - half, simd);
+            return merge_fct(lhs, rhs);
+        }
+
+        template <class R, class RF, class MF, class It, class S>
+        inline R reduce_range(RF& reduce_fct, MF& merge_fct, const R& init, It first, std::size_t size,
+                              S simd, summation::naive_type)
+        {
+            return reduce_block(reduce_fct, merge_fct, init, first, size, simd);
+        }
+
+        template <class R, class RF, class MF, class It, class S>
+        inline R reduce_range(RF& reduce_fct, MF& merge_fct, const R& init, It first, std::size_t size,
+                              S simd, summation::pairwise_type)
+        {
+            return reduce_pairwise(reduce_fct, merge_fct, init, first, size, simd);
+        }
+
+        template <class R, class RF, class MF, class It, class S>
+        inline kahan_accumulator<R> reduce_range(RF&, MF&, const R& init, It first, std::size_t size,
+                                                 S simd, summation::kahan_type)
+        {
+            return kahan_block(init, first, size, simd);
+        }
+
+        template <class MF, class M>
+        inline MF& range_merge(MF& merge_fct, M)
+        {
+            return merge_fct;
+        }
+
+        template <class MF>
+        inline kahan_merge range_merge(MF&, summation::kahan_type)
+        {
+            return kahan_merge();
+        }
+
+        template <class R>
+        inline R range_value(const R& partial)
+        {
+            return partial;
+        }
+
+        template <class R>
+        inline R range_value(const kahan_accumulator<R>& partial)
+        {
+            return partial.value();
+        }
+
+        template <class E>
+        inline auto reduce_block_begin(const E& e, std::true_type /*simd*/)
+        {
+            return e.data();
+        }
+
+        template <class E>
+        inline auto reduce_block_begin(const E& e, std::false_type /*simd*/)
+        {
+            return e.storage().cbegin();
+        }
+
+        /**
+         * Reduces the whole storage of a container. The storage is split in blocks
+         * of the grain size of the current execution policy; each block is reduced
+         * with independent (possibly SIMD) accumulators, and the partial results
+         * are merged pairwise. The result does not depend on the number of threads.
+         */
+        template <class R, class RF, class MF, class E, class M>
+        inline R reduce_storage(RF& reduce_fct, MF& merge_fct, const R& init, const E& e, M mode)
+        {
+            using storage_type = std::decay_t<decltype(e.storage())>;
+            using simd = use_simd_reduction<storage_type, R, std::decay_t<RF>>;
+
+            auto first = reduce_block_begin(e, simd());
+            const std::size_t size = e.storage().size();
+            const execution::execution_policy& policy = execution::default_policy();
+            const std::size_t block_size = policy.grain_size();
+            const std::size_t nb_blocks = (size + block_size - 1) / block_size;
+            if (nb_blocks <= 1)
+            {
+                return range_value(reduce_range(reduce_fct, merge_fct, init, first, size, simd(), mode));
+            }
+
+            using partial_type = decltype(reduce_range(reduce_fct, merge_fct, init, first, size, simd(), mode));
+            uvector<partial_type> partials(nb_blocks);
+            execution::parallel_for(policy.with_grain_size(1), 0, nb_blocks,
+                                    [&](std::size_t block_first, std::size_t block_last)
+            {
+                for (std::size_t b = block_first; b < block_last; ++b)
+                {
+                    std::size_t offset = b * block_size;
+                    partials[b] = reduce_range(reduce_fct, merge_fct, init,
+                                               first + static_cast<std::ptrdiff_t>(offset),
+                                               std::min(block_size, size - offset), simd(), mode);
+                }
+            });
+            auto&& partial_merge = range_merge(merge_fct, mode);
+            return range_value(merge_pairwise(partial_merge, partials.data(), nb_blocks));
+        }
+
+        template <class R, class RF, class MF, class It, class S, class M>
+        inline R reduce_contiguous(RF& reduce_fct, MF&, const R& init,
+                                   It first, std::size_t size, std::false_type /*split*/, S, M)
+        {
+            return std::accumulate(first, first + static_cast<std::ptrdiff_t>(size), init, reduce_fct);
+        }
+
+        template <class R, class RF, class MF, class It, class S, class M>
+        inline R reduce_contiguous(RF& reduce_fct, MF& merge_fct, const R& init,
+                                   It first, std::size_t size, std::true_type /*split*/, S simd, M mode)
+        {
+            // Short rows do not amortize the merge of the accumulators
+            if (size < 4 * reduce_scalar_lanes && !std::is_same<M, summation::kahan_type>::value)
+            {
+                return std::accumulate(first, first + static_cast<std::ptrdiff_t>(size), init, reduce_fct);
+            }
+            return range_value(reduce_range(reduce_fct, merge_fct, init, first, size, simd, mode));
+        }
+
+        template <class R, class RF, class T>
+        inline void reduce_vertical(RF& reduce_fct, R* out, const T* in, std::size_t size, std::false_type /*simd*/)
+        {
+            std::transform(out, out + size, in, out, reduce_fct);
+        }
+
+        template <class R, class RF>
+        inline void reduce_vertical(RF& reduce_fct, R* out, const R* in, std::size_t size, std::true_type /*simd*/)
+        {
+            constexpr std::size_t simd_size = xt_simd::simd_traits<R>::size;
+            std::size_t i = 0;
+            for (; i + simd_size <= size; i += simd_size)
+            {
+                auto acc = xt_simd::load_simd<R, R>(out + i, xt_simd::unaligned_mode());
+                auto val = xt_simd::load_simd<R, R>(in + i, xt_simd::unaligned_mode());
+                xt_simd::store_simd<R, R>(out + i, reduce_fct.simd_apply(acc, val), xt_simd::unaligned_mode());
+            }
+            for (; i < size; ++i)
+            {
+                out[i] = reduce_fct(out[i], in[i]);
+            }
+        }
+
+        template <class R, class RF, class T, class S>
+        inline void reduce_vertical(RF& reduce_fct, R* out, R*, const T* in, std::size_t size,
+                                    S simd, std::false_type /*compensated*/)
+        {
+            reduce_vertical(reduce_fct, out, in, size, simd);
+        }
+
+        template <class R, class RF, class T, class S>
+        inline void reduce_vertical(RF&, R* out, R* compensation, const T* in, std::size_t size,
+                                    S, std::true_type /*compensated*/)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                R y = static_cast<R>(in[i]) - compensation[i];
+                R t = out[i] + y;
+                compensation[i] = (t - out[i]) - y;
+                out[i] = t;
+            }
+        }
+
+        template <class R>
+        inline void apply_compensation(R*, const R*, std::size_t, std::false_type /*compensated*/)
+        {
+        }
+
+        template <class R>
+        inline void apply_compensation(R* out, const R* compensation, std::size_t size, std::true_type /*compensated*/)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                out[i] -= compensation[i];
+            }
+        }
+
+        template <class R, class O>
+        struct immediate_options
+        {
+            using type = reducer_options<R, O>;
+
+            static type get(const O& options)
+            {
+                return type(options);
+            }
+        };
+
+        template <class R, class V, class T>
+        struct immediate_options<R, reducer_options<V, T>>
+        {
+            using type = reducer_options<R, T>;
+
+            static type get(const reducer_options<V, T>& options)
+            {
+                type res;
+                if (type::has_initial_value)
+                {
+                    res.initial_value = static_cast<R>(options.initial_value);
+                }
+                return res;
+            }
+        };
+
+        template <class R, class RF, class IF, class MF, class E, class O, class M>
+        inline R reduce_all(RF& reduce_fct, IF& init_fct, MF&, const E& e, const O& options, std::false_type, M)
+        {
+            R tmp = O::has_initial_value ? options.initial_value : init_fct();
+            return std::accumulate(e.storage().begin(), e.storage().end(), tmp, reduce_fct);
+        }
+
+        template <class R, class RF, class IF, class MF, class E, class O, class M>
+        inline R reduce_all(RF& reduce_fct, IF& init_fct, MF& merge_fct, const E& e, const O& options, std::true_type, M mode)
+        {
+            R res = reduce_storage(reduce_fct, merge_fct, static_cast<R>(init_fct()), e, mode);
+            return O::has_initial_value ? static_cast<R>(merge_fct(options.initial_value, res)) : res;
+        }
+    }
+
     template <class F, class E, class X, class O>
     inline auto reduce_immediate(F&& f, E&& e, X&& axes, O&& raw_options)
     {
@@ -268,8 +838,8 @@ namespace xt
         using expr_value_type = typename std::decay_t<E>::value_type;
         using result_type = std::decay_t<decltype(std::declval<reduce_functor_type>()(std::declval<init_functor_type>()(), std::declval<expr_value_type>()))>;
 
-        using options_t = reducer_options<result_type, std::decay_t<O>>;
-        options_t options(raw_options);
+        using options_t = typename detail::immediate_options<result_type, std::decay_t<O>>::type;
+        options_t options = detail::immediate_options<result_type, std::decay_t<O>>::get(raw_options);
 
         using shape_type = typename xreducer_shape_type<typename std::decay_t<E>::shape_type, std::decay_t<X>, typename options_t::keep_dims>::type;
         using result_container_type = typename detail::xtype_for_shape<shape_type>::template type<result_type, std::decay_t<E>::static_layout>;
@@ -309,11 +879,16 @@ namespace xt
 
         detail::shape_computation<options_t>(result_shape, result, e, axes);
 
+        using summation_algorithm = detail::summation_algorithm<std::decay_t<F>, result_type, typename options_t::summation>;
+        using summation_type = typename summation_algorithm::type;
+        using compensated = typename summation_algorithm::compensated_columns;
+
         // Fast track for complete reduction
         if (e.dimension() == axes.size())
         {
-            result_type tmp = options_t::has_initial_value ? options.initial_value : init_fct();
-            result.data()[0] = std::accumulate(e.storage().begin(), e.storage().end(), tmp, reduce_fct);
+            result.data()[0] = detail::reduce_all<result_type>(reduce_fct, init_fct, merge_fct, e, options,
+                                                               detail::allows_split_reduction<std::decay_t<F>>(),
+                                                               summation_type());
             return result;
         }
 
@@ -425,6 +1000,9 @@ namespace xt
         auto merge_border = out;
         bool merge = false;
 
+        using split = detail::allows_split_reduction<std::decay_t<F>>;
+        using simd = detail::use_simd_reduction<std::decay_t<decltype(e.storage())>, result_type, std::decay_t<reduce_functor_type>>;
+
         // TODO there could be some performance gain by removing merge checking
         //      when axes.size() == 1 and even next_idx could be removed for something simpler (next_stride always the same)
         //      best way to do this would be to create a function that takes (begin, out, outer_loop_size, inner_loop_size, next_idx_lambda)
@@ -436,7 +1014,7 @@ namespace xt
                 // for unknown reasons it's much faster to use a temporary variable and
                 // std::accumulate here -- probably some cache behavior
                 result_type tmp = init_fct();
-                tmp = std::accumulate(begin , begin + outer_loop_size, tmp, reduce_fct);
+                tmp = detail::reduce_contiguous(reduce_fct, merge_fct, tmp, begin, outer_loop_size, split(), simd(), summation_type());
 
                 // use merge function if necessary
                 *out = merge ? merge_fct(*out, tmp) : tmp;
@@ -461,20 +1039,24 @@ namespace xt
         }
         else
         {
+            // running compensations of the vertical sums, when compensated summation is required
+            uvector<result_type> compensation(compensated::value ? result.size() : std::size_t(0), result_type());
             while (idx_res.first != true)
             {
-                std::transform(out, out + inner_loop_size, begin, out,
-                               [merge, &init_fct, &reduce_fct](auto&& v1, auto&& v2) {
-                                    return merge ?
-                                        reduce_fct(v1, v2) :
-                                        // cast because return type of identity function is not upcasted
-                                        reduce_fct(static_cast<result_type>(init_fct()), v2);
-                               });
-
-                begin += inner_stride;
-                for (std::size_t i = 1; i < outer_loop_size; ++i)
+                result_type* out_compensation = compensation.data() + (compensated::value ? out - out_begin : 0);
+                if (!merge)
                 {
-                    std::transform(out, out + inner_loop_size, begin, out, reduce_fct);
+                    // cast because return type of identity function is not upcasted
+                    std::fill(out, out + inner_loop_size, static_cast<result_type>(init_fct()));
+                    if (compensated::value)
+                    {
+                        std::fill(out_compensation, out_compensation + inner_loop_size, result_type());
+                    }
+                }
+
+                for (std::size_t i = 0; i < outer_loop_size; ++i)
+                {
+                    detail::reduce_vertical(reduce_fct, out, out_compensation, begin, inner_loop_size, simd(), compensated());
                     begin += inner_stride;
                 }
 
@@ -493,6 +1075,7 @@ namespace xt
                     merge = true;
                 }
             };
+            detail::apply_compensation(result.data(), compensation.data(), compensation.size(), compensated());
         }
         if (options_t::has_initial_value)
         {
@@ -704,6 +1287,19 @@ namespace xt
         using size_type = typename xexpression_type::size_type;
     };
 
+    namespace detail
+    {
+        template <class R>
+        struct has_contiguous_reduction
+            : xtl::conjunction<has_data_interface<typename R::xexpression_type>,
+                               std::is_base_of<xcontainer<typename R::xexpression_type>, typename R::xexpression_type>,
+                               std::is_same<typename R::expression_tag, xtensor_expression_tag>,
+                               std::is_same<typename R::value_type, typename xcontainer_inner_types<R>::raw_value_type>,
+                               allows_split_reduction<typename R::xreducer_functors_type>>
+        {
+        };
+    }
+
     template <class T>
     struct select_dim_mapping_type
     {
@@ -801,6 +1397,9 @@ namespace xt
         template <class S>
         bool has_linear_assign(const S& strides) const noexcept;
 
+        template <class E, class R = self_type, class = std::enable_if_t<detail::has_contiguous_reduction<R>::value>>
+        void assign_to(xexpression<E>& e) const;
+
         template <class S>
         const_stepper stepper_begin(const S& shape) const noexcept;
         template <class S>
@@ -1013,6 +1612,13 @@ namespace xt
         reference aggregate_impl(size_type dim, /*keep_dims=*/ std::false_type) const;
         reference aggregate_impl(size_type dim, /*keep_dims=*/ std::true_type) const;
 
+        using summation_type = detail::summation_algorithm_t<typename xreducer_type::xreducer_functors_type,
+                                                             value_type,
+                                                             typename O::summation>;
+        reference reduce_axis(size_type index, size_type size, summation::naive_type) const;
+        reference reduce_axis(size_type index, size_type size, summation::pairwise_type) const;
+        reference reduce_axis(size_type index, size_type size, summation::kahan_type) const;
+
         substepper_type get_substepper_begin() const;
         size_type get_dim(size_type dim) const noexcept;
         size_type shape(size_type i) const noexcept;
@@ -1478,6 +2084,31 @@ namespace xt
     }
     //@}
 
+    /**
+     * Assigns the reducer to the specified expression. When the reduced expression
+     * is a contiguous container, the kernels of the immediate reduction are used:
+     * they accumulate whole contiguous rows (with SIMD along the innermost axis,
+     * or vertically when reducing outer axes) instead of computing one element
+     * of the result at a time.
+     * @param e the expression to assign to
+     */
+    template <class F, class CT, class X, class O>
+    template <class E, class R, class>
+    inline void xreducer<F, CT, X, O>::assign_to(xexpression<E>& e) const
+    {
+        bool contiguous = m_e.size() != size_type(0) && m_axes.size() != 0 && m_e.is_contiguous() &&
+                          (m_e.layout() == layout_type::row_major || m_e.layout() == layout_type::column_major);
+        if (contiguous)
+        {
+            auto res = reduce_immediate(functors(), m_e, m_axes, m_options);
+            xexpression_assigner<xtensor_expression_tag>::assign_xexpression(e, res);
+        }
+        else
+        {
+            xexpression_assigner<xtensor_expression_tag>::assign_xexpression(e, *this);
+        }
+    }
+
     template <class F, class CT, class X, class O>
     template <class S>
     inline auto xreducer<F, CT, X, O>::stepper_begin(const S& shape) const noexcept -> const_stepper
@@ -1656,12 +2287,7 @@ namespace xt
         }
         else
         {
-            res = static_cast<reference>(m_reducer->m_init());
-            for (size_type i = 0; i != size; ++i, m_stepper.step(index))
-            {
-                res = m_reducer->m_reduce(res, *m_stepper);
-            }
-            m_stepper.step_back(index);
+            res = reduce_axis(index, size, summation_type());
         }
         m_stepper.reset(index);
         return res;
@@ -1688,12 +2314,7 @@ namespace xt
             }
             else
             {
-                res = m_reducer->m_init();
-                for (size_type i = 0; i != size; ++i, m_stepper.step(index))
-                {
-                    res = m_reducer->m_reduce(res, *m_stepper);
-                }
-                m_stepper.step_back(index);
+                res = reduce_axis(index, size, summation_type());
             }
             m_stepper.reset(index);
         }
@@ -1708,6 +2329,53 @@ namespace xt
     }
 
 
+    template <class F, class CT, class X, class O>
+    inline auto xreducer_stepper<F, CT, X, O>::reduce_axis(size_type index, size_type size,
+                                                           summation::naive_type) const -> reference
+    {
+        reference res = static_cast<reference>(m_reducer->m_init());
+        for (size_type i = 0; i != size; ++i, m_stepper.step(index))
+        {
+            res = m_reducer->m_reduce(res, *m_stepper);
+        }
+        m_stepper.step_back(index);
+        return res;
+    }
+
+    template <class F, class CT, class X, class O>
+    inline auto xreducer_stepper<F, CT, X, O>::reduce_axis(size_type index, size_type size,
+                                                           summation::pairwise_type) const -> reference
+    {
+        using merge_type = typename xreducer_type::merge_functor_type;
+        detail::pairwise_cascade<reference, merge_type> cascade(m_reducer->m_merge);
+        size_type i = 0;
+        while (i != size)
+        {
+            size_type last = std::min(size, i + size_type(detail::pairwise_block_size));
+            reference block = static_cast<reference>(m_reducer->m_init());
+            for (; i != last; ++i, m_stepper.step(index))
+            {
+                block = m_reducer->m_reduce(block, *m_stepper);
+            }
+            cascade.push(std::move(block));
+        }
+        m_stepper.step_back(index);
+        return cascade.value(static_cast<reference>(m_reducer->m_init()));
+    }
+
+    template <class F, class CT, class X, class O>
+    inline auto xreducer_stepper<F, CT, X, O>::reduce_axis(size_type index, size_type size,
+                                                           summation::kahan_type) const -> reference
+    {
+        detail::kahan_accumulator<reference> acc = {static_cast<reference>(m_reducer->m_init()), reference(0)};
+        for (size_type i = 0; i != size; ++i, m_stepper.step(index))
+        {
+            acc.add(static_cast<reference>(*m_stepper));
+        }
+        m_stepper.step_back(index);
+        return acc.value();
+    }
+
     template <class F, class CT, class X, class O>
     inline auto xreducer_stepper<F, CT, X, O>::get_substepper_begin() const -> substepper_type
     {
@@ -11,14 +11,19 @@
 #define XTENSOR_XSET_OPERATION_HPP
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <memory>
 #include <type_traits>
+#include <vector>
 
 #include <xtl/xsequence.hpp>
 
 #include "xfunction.hpp"
 #include "xutils.hpp"
 #include "xscalar.hpp"
+#include "xstorage.hpp"
 #include "xstrides.hpp"
 #include "xstrided_view.hpp"
 #include "xmath.hpp"
@@ -28,14 +33,185 @@ namespace xt
 
     namespace detail
     {
+        template <class T>
+        struct is_membership_hashable
+            : std::integral_constant<bool, std::is_arithmetic<T>::value && sizeof(T) <= sizeof(std::uint64_t)>
+        {
+        };
+
+        // Hash of arithmetic values, 0 and -0 share the same hash
+        template <class T>
+        inline std::size_t membership_hash(const T& value) noexcept
+        {
+            std::uint64_t bits = 0;
+            if (value != T(0))
+            {
+                std::memcpy(&bits, &value, sizeof(T));
+            }
+            // splitmix64 finalizer
+            bits ^= bits >> 30;
+            bits *= 0xbf58476d1ce4e5b9ULL;
+            bits ^= bits >> 27;
+            bits *= 0x94d049bb133111ebULL;
+            bits ^= bits >> 31;
+            return static_cast<std::size_t>(bits);
+        }
+
+        /**
+         * Set of arithmetic values built once for membership tests. Small
+         * sets are kept sorted and searched with a branchless binary search,
+         * larger ones are stored in an open-addressing hash table with linear
+         * probing. NaNs are never members, as with ``operator==``.
+         */
+        template <class T>
+        class xmembership_set
+        {
+        public:
+
+            static constexpr std::size_t sorted_threshold = 128;
+
+            template <class It>
+            xmembership_set(It first, It last, bool assume_unique);
+
+            bool contains(const T& value) const noexcept;
+
+        private:
+
+            bool contains_sorted(const T& value) const noexcept;
+            bool contains_hashed(const T& value) const noexcept;
+
+            uvector<T> m_values;
+            uvector<unsigned char> m_used;
+            std::size_t m_mask;
+        };
+
+        template <class T>
+        template <class It>
+        inline xmembership_set<T>::xmembership_set(It first, It last, bool assume_unique)
+            : m_mask(0)
+        {
+            std::vector<T> values;
+            for (; first != last; ++first)
+            {
+                T value = static_cast<T>(*first);
+                if (value == value)
+                {
+                    values.push_back(value);
+                }
+            }
+
+            if (values.size() <= sorted_threshold)
+            {
+                std::sort(values.begin(), values.end());
+                auto end = assume_unique ? values.end() : std::unique(values.begin(), values.end());
+                m_values.resize(static_cast<std::size_t>(end - values.begin()));
+                std::copy(values.begin(), end, m_values.begin());
+                return;
+            }
+
+            std::size_t capacity = 16;
+            while (capacity < 2 * values.size())
+            {
+                capacity *= 2;
+            }
+            m_mask = capacity - 1;
+            m_values.resize(capacity);
+            m_used.resize(capacity);
+            std::fill(m_used.begin(), m_used.end(), static_cast<unsigned char>(0));
+            for (const auto& value : values)
+            {
+                std::size_t slot = membership_hash(value) & m_mask;
+                while (m_used[slot] && (assume_unique || !(m_values[slot] == value)))
+                {
+                    slot = (slot + 1) & m_mask;
+                }
+                m_values[slot] = value;
+                m_used[slot] = 1;
+            }
+        }
+
+        template <class T>
+        inline bool xmembership_set<T>::contains(const T& value) const noexcept
+        {
+            return m_used.empty() ? contains_sorted(value) : contains_hashed(value);
+        }
+
+        template <class T>
+        inline bool xmembership_set<T>::contains_sorted(const T& value) const noexcept
+        {
+            std::size_t n = m_values.size();
+            if (n == 0)
+            {
+                return false;
+            }
+            // base ends on the last element not greater than value (or the first one)
+            const T* base = m_values.data();
+            while (n > 1)
+            {
+                std::size_t half = n / 2;
+                base = (base[half] <= value) ? base + half : base;
+                n -= half;
+            }
+            return *base == value;
+        }
+
+        template <class T>
+        inline bool xmembership_set<T>::contains_hashed(const T& value) const noexcept
+        {
+            std::size_t slot = membership_hash(value) & m_mask;
+            while (m_used[slot])
+            {
+                if (m_values[slot] == value)
+                {
+                    return true;
+                }
+                slot = (slot + 1) & m_mask;
+            }
+            return false;
+        }
+
+        template <class T>
+        struct isin_functor
+        {
+            std::shared_ptr<const xmembership_set<T>> m_set;
+            bool m_invert;
+
+            bool operator()(const T& t) const noexcept
+            {
+                return m_set->contains(t) != m_invert;
+            }
+        };
+
+        // The set is only used when test elements and elements have the
+        // same arithmetic type, so that no conversion changes the result.
+        template <class E, class It>
+        using use_membership_set = std::integral_constant<bool,
+            is_membership_hashable<xvalue_type_t<std::decay_t<E>>>::value &&
+            std::is_same<xvalue_type_t<std::decay_t<E>>, std::decay_t<decltype(*std::declval<It>())>>::value>;
+
+        template <class E, class It>
+        inline auto make_isin(E&& element, It first, It last, bool assume_unique, bool invert, std::true_type)
+        {
+            using value_type = xvalue_type_t<std::decay_t<E>>;
+            auto set = std::make_shared<const xmembership_set<value_type>>(first, last, assume_unique);
+            return make_lambda_xfunction(isin_functor<value_type>{std::move(set), invert}, std::forward<E>(element));
+        }
+
+        template <class E, class It>
+        inline auto make_isin(E&& element, It first, It last, bool /*assume_unique*/, bool invert, std::false_type)
+        {
+            auto lambda = [first, last, invert](const auto& t) {
+                return (std::find(first, last, t) != last) != invert; };
+            return make_lambda_xfunction(std::move(lambda), std::forward<E>(element));
+        }
 
         template <bool lvalue>
         struct lambda_isin
         {
             template <class E>
-            static auto make(E&& e)
+            static auto make(E&& e, bool invert)
             {
-                return [&e](const auto& t) { return std::find(e.begin(), e.end(), t) != e.end(); };
+                return [&e, invert](const auto& t) { return (std::find(e.begin(), e.end(), t) != e.end()) != invert; };
             }
         };
 
@@ -43,12 +219,25 @@ namespace xt
         struct lambda_isin<false>
         {
             template <class E>
-            static auto make(E&& e)
+            static auto make(E&& e, bool invert)
             {
-                return [e](const auto& t) { return std::find(e.begin(), e.end(), t) != e.end(); };
+                return [e, invert](const auto& t) { return (std::find(e.begin(), e.end(), t) != e.end()) != invert; };
             }
         };
 
+        template <class E, class F>
+        inline auto make_isin(E&& element, F&& test_elements, bool assume_unique, bool invert, std::true_type)
+        {
+            return make_isin(std::forward<E>(element), test_elements.begin(), test_elements.end(),
+                             assume_unique, invert, std::true_type());
+        }
+
+        template <class E, class F>
+        inline auto make_isin(E&& element, F&& test_elements, bool /*assume_unique*/, bool invert, std::false_type)
+        {
+            auto lambda = lambda_isin<std::is_lvalue_reference<F>::value>::make(std::forward<F>(test_elements), invert);
+            return make_lambda_xfunction(std::move(lambda), std::forward<E>(element));
+        }
     }
 
     /**
@@ -57,16 +246,21 @@ namespace xt
     *
     * Returns a boolean array of the same shape as ``element`` that is ``true`` where an element of
     * ``element`` is in ``test_elements`` and ``False`` otherwise.
+    * When elements and test elements have the same arithmetic type, the test elements are stored
+    * once in a hash set (or a sorted array for small sets); the result is still evaluated lazily.
     * @param element an \ref xexpression
     * @param test_elements an array
+    * @param assume_unique if ``true``, the test elements are assumed to be unique
+    * @param invert if ``true``, the result is ``true`` where an element is not in ``test_elements``
     * @return a boolean array
     */
     template <class E, class T>
-    inline auto isin(E&& element, std::initializer_list<T> test_elements) noexcept
+    inline auto isin(E&& element, std::initializer_list<T> test_elements,
+                     bool assume_unique = false, bool invert = false)
     {
-        auto lambda = [test_elements](const auto& t) {
-            return std::find(test_elements.begin(), test_elements.end(), t) != test_elements.end(); };
-        return make_lambda_xfunction(std::move(lambda), std::forward<E>(element));
+        using use_set = detail::use_membership_set<E, const T*>;
+        return detail::make_isin(std::forward<E>(element), test_elements.begin(), test_elements.end(),
+                                 assume_unique, invert, use_set());
     }
 
     /**
@@ -75,15 +269,20 @@ namespace xt
     *
     * Returns a boolean array of the same shape as ``element`` that is ``true`` where an element of
     * ``element`` is in ``test_elements`` and ``False`` otherwise.
+    * When elements and test elements have the same arithmetic type, the test elements are stored
+    * once in a hash set (or a sorted array for small sets); the result is still evaluated lazily.
     * @param element an \ref xexpression
     * @param test_elements an array
+    * @param assume_unique if ``true``, the test elements are assumed to be unique
+    * @param invert if ``true``, the result is ``true`` where an element is not in ``test_elements``
     * @return a boolean array
     */
     template <class E, class F, class = typename std::enable_if_t<has_iterator_interface<F>::value>>
-    inline auto isin(E&& element, F&& test_elements) noexcept
+    inline auto isin(E&& element, F&& test_elements, bool assume_unique = false, bool invert = false)
     {
-        auto lambda = detail::lambda_isin<std::is_lvalue_reference<F>::value>::make(std::forward<F>(test_elements));
-        return make_lambda_xfunction(std::move(lambda), std::forward<E>(element));
+        using use_set = detail::use_membership_set<E, decltype(test_elements.begin())>;
+        return detail::make_isin(std::forward<E>(element), std::forward<F>(test_elements),
+                                 assume_unique, invert, use_set());
     }
 
     /**
@@ -92,17 +291,22 @@ namespace xt
     *
     * Returns a boolean array of the same shape as ``element`` that is ``true`` where an element of
     * ``element`` is in ``test_elements`` and ``False`` otherwise.
+    * When elements and test elements have the same arithmetic type, the test elements are stored
+    * once in a hash set (or a sorted array for small sets); the result is still evaluated lazily.
     * @param element an \ref xexpression
     * @param test_elements_begin iterator to the beginning of an array
     * @param test_elements_end iterator to the end of an array
+    * @param assume_unique if ``true``, the test elements are assumed to be unique
+    * @param invert if ``true``, the result is ``true`` where an element is not in ``test_elements``
     * @return a boolean array
     */
     template <class E, class I, class = typename std::enable_if_t<is_iterator<I>::value>>
-    inline auto isin(E&& element, I&& test_elements_begin, I&& test_elements_end) noexcept
+    inline auto isin(E&& element, I&& test_elements_begin, I&& test_elements_end,
+                     bool assume_unique = false, bool invert = false)
     {
-        auto lambda = [&test_elements_begin, &test_elements_end](const auto& t) {
-            return std::find(test_elements_begin, test_elements_end, t) != test_elements_end; };
-        return make_lambda_xfunction(std::move(lambda), std::forward<E>(element));
+        using use_set = detail::use_membership_set<E, std::decay_t<I>>;
+        return detail::make_isin(std::forward<E>(element), std::decay_t<I>(test_elements_begin),
+                                 std::decay_t<I>(test_elements_end), assume_unique, invert, use_set());
     }
 
     /**
@@ -113,13 +317,17 @@ namespace xt
     * ``element`` is in ``test_elements`` and ``False`` otherwise.
     * @param element an \ref xexpression
     * @param test_elements an array
+    * @param assume_unique if ``true``, the test elements are assumed to be unique
+    * @param invert if ``true``, the result is ``true`` where an element is not in ``test_elements``
     * @return a boolean array
     */
     template <class E, class T>
-    inline auto in1d(E&& element, std::initializer_list<T> test_elements) noexcept
+    inline auto in1d(E&& element, std::initializer_list<T> test_elements,
+                     bool assume_unique = false, bool invert = false)
     {
         XTENSOR_ASSERT(element.dimension() == 1ul);
-        return isin(std::forward<E>(element), std::forward<std::initializer_list<T>>(test_elements));
+        return isin(std::forward<E>(element), std::forward<std::initializer_list<T>>(test_elements),
+                    assume_unique, invert);
     }
 
     /**
@@ -130,14 +338,16 @@ namespace xt
     * ``element`` is in ``test_elements`` and ``False`` otherwise.
     * @param element an \ref xexpression
     * @param test_elements an array
+    * @param assume_unique if ``true``, the test elements are assumed to be unique
+    * @param invert if ``true``, the result is ``true`` where an element is not in ``test_elements``
     * @return a boolean array
     */
     template <class E, class F, class = typename std::enable_if_t<has_iterator_interface<F>::value>>
-    inline auto in1d(E&& element, F&& test_elements) noexcept
+    inline auto in1d(E&& element, F&& test_elements, bool assume_unique = false, bool invert = false)
     {
         XTENSOR_ASSERT(element.dimension() == 1ul);
         XTENSOR_ASSERT(test_elements.dimension() == 1ul);
-        return isin(std::forward<E>(element), std::forward<F>(test_elements));
+        return isin(std::forward<E>(element), std::forward<F>(test_elements), assume_unique, invert);
     }
 
     /**
@@ -149,13 +359,17 @@ namespace xt
     * @param element an \ref xexpression
     * @param test_elements_begin iterator to the beginning of an array
     * @param test_elements_end iterator to the end of an array
+    * @param assume_unique if ``true``, the test elements are assumed to be unique
+    * @param invert if ``true``, the result is ``true`` where an element is not in ``test_elements``
     * @return a boolean array
     */
     template <class E, class I, class = typename std::enable_if_t<is_iterator<I>::value>>
-    inline auto in1d(E&& element, I&& test_elements_begin, I&& test_elements_end) noexcept
+    inline auto in1d(E&& element, I&& test_elements_begin, I&& test_elements_end,
+                     bool assume_unique = false, bool invert = false)
     {
         XTENSOR_ASSERT(element.dimension() == 1ul);
-        return isin(std::forward<E>(element), std::forward<I>(test_elements_begin), std::forward<I>(test_elements_end));
+        return isin(std::forward<E>(element), std::forward<I>(test_elements_begin), std::forward<I>(test_elements_end),
+                    assume_unique, invert);
     }
 
     /**
@@ -11,17 +11,393 @@
 #define XTENSOR_SORT_HPP
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "xarray.hpp"
 #include "xeval.hpp"
+#include "xexecution.hpp"
 #include "xslice.hpp"  // for xnone
 #include "xmanipulation.hpp"
+#include "xstorage.hpp"
 #include "xtensor.hpp"
 #include "xtensor_config.hpp"
+#include "xtensor_simd.hpp"
 
 namespace xt
 {
+    /**
+     * Sorting algorithm used by argsort.
+     */
+    enum class sorting_method
+    {
+        /**
+         *  Faster method, no guarantee on the order of equivalent elements
+         */
+        quick,
+        /**
+         *  Slower method, preserves the order of equivalent elements
+         */
+        stable,
+    };
+
+    /***************
+     * Radix sorts *
+     ***************/
+
+    namespace detail
+    {
+        template <std::size_t N>
+        struct radix_unsigned;
+
+        template <>
+        struct radix_unsigned<1>
+        {
+            using type = std::uint8_t;
+        };
+
+        template <>
+        struct radix_unsigned<2>
+        {
+            using type = std::uint16_t;
+        };
+
+        template <>
+        struct radix_unsigned<4>
+        {
+            using type = std::uint32_t;
+        };
+
+        template <>
+        struct radix_unsigned<8>
+        {
+            using type = std::uint64_t;
+        };
+
+        template <class T>
+        struct is_radix_sortable
+            : std::integral_constant<bool, (std::is_integral<T>::value && !std::is_same<T, bool>::value && sizeof(T) <= 8) ||
+                                               std::is_same<T, float>::value || std::is_same<T, double>::value>
+        {
+        };
+
+        /**
+         * Maps values to unsigned keys with the same ordering: the sign bit of
+         * signed integers is flipped, negative floating point numbers have all
+         * their bits flipped and positive ones their sign bit. NaNs are mapped
+         * to the greatest key, so that they are sorted last. encode is a
+         * bijection, rank maps equivalent values (-0.0 and 0.0) to the same key.
+         */
+        template <class T, bool = std::is_floating_point<T>::value, bool = std::is_signed<T>::value>
+        struct radix_key
+        {
+            using key_type = typename radix_unsigned<sizeof(T)>::type;
+
+            static key_type encode(T value) noexcept
+            {
+                return static_cast<key_type>(value);
+            }
+
+            static key_type rank(T value) noexcept
+            {
+                return encode(value);
+            }
+
+            static T decode(key_type key) noexcept
+            {
+                return static_cast<T>(key);
+            }
+        };
+
+        template <class T>
+        struct radix_key<T, false, true>
+        {
+            using key_type = typename radix_unsigned<sizeof(T)>::type;
+            static constexpr key_type sign_bit = key_type(key_type(1) << (8 * sizeof(T) - 1));
+
+            static key_type encode(T value) noexcept
+            {
+                key_type bits;
+                std::memcpy(&bits, &value, sizeof(T));
+                return key_type(bits ^ sign_bit);
+            }
+
+            static key_type rank(T value) noexcept
+            {
+                return encode(value);
+            }
+
+            static T decode(key_type key) noexcept
+            {
+                key_type bits = key_type(key ^ sign_bit);
+                T value;
+                std::memcpy(&value, &bits, sizeof(T));
+                return value;
+            }
+        };
+
+        template <class T>
+        struct radix_key<T, true, true>
+        {
+            using key_type = typename radix_unsigned<sizeof(T)>::type;
+            static constexpr key_type sign_bit = key_type(key_type(1) << (8 * sizeof(T) - 1));
+
+            static key_type encode(T value) noexcept
+            {
+                if (value != value)
+                {
+                    return key_type(~key_type(0));
+                }
+                key_type bits;
+                std::memcpy(&bits, &value, sizeof(T));
+                return (bits & sign_bit) ? key_type(~bits) : key_type(bits | sign_bit);
+            }
+
+            static key_type rank(T value) noexcept
+            {
+                return value == T(0) ? sign_bit : encode(value);
+            }
+
+            static T decode(key_type key) noexcept
+            {
+                key_type bits = (key & sign_bit) ? key_type(key & ~sign_bit) : key_type(~key);
+                T value;
+                std::memcpy(&value, &bits, sizeof(T));
+                return value;
+            }
+        };
+
+        /**
+         * LSD radix sort of keys, with 8-bit digits. The permutation is also
+         * applied to the payload idx when it is not null. The sort is stable.
+         * On return, keys and idx point to the sorted sequences, which are
+         * either the input ones or the buffers.
+         */
+        template <class K, class I>
+        inline void radix_sort_impl(K*& keys, K*& keys_buffer, I*& idx, I*& idx_buffer, std::size_t n)
+        {
+            constexpr std::size_t nb_passes = sizeof(K);
+            constexpr std::size_t nb_buckets = 256;
+            std::array<std::array<std::size_t, nb_buckets>, nb_passes> counts;
+            for (auto& c : counts)
+            {
+                c.fill(0);
+            }
+
+            auto digit = [](K key, std::size_t pass) {
+                return static_cast<std::size_t>((key >> (8 * pass)) & K(0xFF));
+            };
+
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                for (std::size_t pass = 0; pass < nb_passes; ++pass)
+                {
+                    ++counts[pass][digit(keys[i], pass)];
+                }
+            }
+
+            for (std::size_t pass = 0; pass < nb_passes; ++pass)
+            {
+                auto& offsets = counts[pass];
+                // all keys share this digit: nothing to do for this pass
+                if (n == 0 || offsets[digit(keys[0], pass)] == n)
+                {
+                    continue;
+                }
+                std::size_t sum = 0;
+                for (auto& c : offsets)
+                {
+                    std::size_t tmp = c;
+                    c = sum;
+                    sum += tmp;
+                }
+                if (idx != nullptr)
+                {
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        std::size_t dst = offsets[digit(keys[i], pass)]++;
+                        keys_buffer[dst] = keys[i];
+                        idx_buffer[dst] = idx[i];
+                    }
+                    std::swap(idx, idx_buffer);
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        keys_buffer[offsets[digit(keys[i], pass)]++] = keys[i];
+                    }
+                }
+                std::swap(keys, keys_buffer);
+            }
+        }
+
+        template <class T>
+        inline void radix_sort(T* first, T* last)
+        {
+            using key_traits = radix_key<T>;
+            using key_type = typename key_traits::key_type;
+
+            std::size_t n = static_cast<std::size_t>(last - first);
+            uvector<key_type> keys(n);
+            uvector<key_type> buffer(n);
+            std::transform(first, last, keys.begin(), &key_traits::encode);
+
+            key_type* keys_ptr = keys.data();
+            key_type* buffer_ptr = buffer.data();
+            std::size_t* no_idx = nullptr;
+            std::size_t* no_idx_buffer = nullptr;
+            radix_sort_impl(keys_ptr, buffer_ptr, no_idx, no_idx_buffer, n);
+            std::transform(keys_ptr, keys_ptr + n, first, &key_traits::decode);
+        }
+
+        template <class T, class I>
+        inline void radix_argsort(const T* data, I* idx, std::size_t n)
+        {
+            using key_traits = radix_key<T>;
+            using key_type = typename key_traits::key_type;
+
+            uvector<key_type> keys(n);
+            uvector<key_type> buffer(n);
+            uvector<I> idx_buffer(n);
+            std::transform(data, data + n, keys.begin(), &key_traits::rank);
+            std::iota(idx, idx + n, I(0));
+
+            key_type* keys_ptr = keys.data();
+            key_type* buffer_ptr = buffer.data();
+            I* idx_ptr = idx;
+            I* idx_buffer_ptr = idx_buffer.data();
+            radix_sort_impl(keys_ptr, buffer_ptr, idx_ptr, idx_buffer_ptr, n);
+            if (idx_ptr != idx)
+            {
+                std::copy(idx_ptr, idx_ptr + n, idx);
+            }
+        }
+
+        /**
+         * Strict weak ordering where NaNs are greater than any other value,
+         * as with the keys of the radix sort, so that all the sorting paths
+         * give the same order. Other value types are compared with operator<.
+         */
+        struct nan_last_less
+        {
+            template <class T>
+            bool operator()(const T& lhs, const T& rhs) const
+            {
+                return less(lhs, rhs, typename std::is_floating_point<T>::type());
+            }
+
+        private:
+
+            template <class T>
+            static bool less(const T& lhs, const T& rhs, std::true_type /*is_floating_point*/)
+            {
+                return lhs < rhs || (rhs != rhs && lhs == lhs);
+            }
+
+            template <class T>
+            static bool less(const T& lhs, const T& rhs, std::false_type /*is_floating_point*/)
+            {
+                return lhs < rhs;
+            }
+        };
+
+        template <class T>
+        inline bool use_radix_sort(std::size_t n) noexcept
+        {
+            return is_radix_sortable<T>::value && n >= std::size_t(XTENSOR_RADIX_SORT_THRESHOLD);
+        }
+
+        // sorts a contiguous range, with a radix sort when possible
+        template <class T>
+        inline void sort_range(T* first, T* last, std::true_type /*radix sortable*/)
+        {
+            if (use_radix_sort<T>(static_cast<std::size_t>(last - first)))
+            {
+                radix_sort(first, last);
+            }
+            else
+            {
+                std::sort(first, last, nan_last_less());
+            }
+        }
+
+        template <class T>
+        inline void sort_range(T* first, T* last, std::false_type /*radix sortable*/)
+        {
+            std::sort(first, last, nan_last_less());
+        }
+
+        template <class T>
+        inline void sort_range(T* first, T* last)
+        {
+            sort_range(first, last, typename is_radix_sortable<T>::type());
+        }
+
+        template <class It>
+        inline void sort_range(It first, It last)
+        {
+            std::sort(first, last, nan_last_less());
+        }
+
+        template <class It, class C>
+        inline void sort_range(It first, It last, C comp)
+        {
+            std::sort(first, last, comp);
+        }
+
+        template <class T>
+        inline void sort_range(T* first, T* last, nan_last_less)
+        {
+            sort_range(first, last);
+        }
+
+        // argsorts a contiguous range, with a radix sort when possible
+        template <class T, class I>
+        inline void argsort_range(const T* data, I* idx, std::size_t n, sorting_method method, std::false_type /*radix sortable*/)
+        {
+            auto comp = [data](std::size_t x, std::size_t y) {
+                return nan_last_less()(*(data + x), *(data + y));
+            };
+            std::iota(idx, idx + n, I(0));
+            if (method == sorting_method::stable)
+            {
+                std::stable_sort(idx, idx + n, comp);
+            }
+            else
+            {
+                std::sort(idx, idx + n, comp);
+            }
+        }
+
+        template <class T, class I>
+        inline void argsort_range(const T* data, I* idx, std::size_t n, sorting_method method, std::true_type /*radix sortable*/)
+        {
+            if (use_radix_sort<T>(n))
+            {
+                radix_argsort(data, idx, n);
+            }
+            else
+            {
+                argsort_range(data, idx, n, method, std::false_type());
+            }
+        }
+
+        template <class T, class I>
+        inline void argsort_range(const T* data, I* idx, std::size_t n, sorting_method method)
+        {
+            argsort_range(data, idx, n, method, typename is_radix_sortable<T>::type());
+        }
+    }
+
     namespace detail
     {
         template <class T>
@@ -30,8 +406,9 @@ namespace xt
             return stride != 0 ? stride : static_cast<std::ptrdiff_t>(shape);
         }
 
-        template <class E, class F>
-        inline void call_over_leading_axis(E& ev, F&& fct)
+        // returns the number of lanes along the leading axis and the distance between two lanes
+        template <class E>
+        inline std::pair<std::size_t, std::ptrdiff_t> leading_axis_lanes(const E& ev)
         {
             std::size_t n_iters = 1;
             std::ptrdiff_t secondary_stride;
@@ -50,6 +427,15 @@ namespace xt
                 secondary_stride = adjust_secondary_stride(ev.strides()[1],
                                                            *(ev.shape().begin()));
             }
+            return std::make_pair(n_iters, secondary_stride);
+        }
+
+        template <class E, class F>
+        inline void call_over_leading_axis(E& ev, F&& fct)
+        {
+            std::size_t n_iters;
+            std::ptrdiff_t secondary_stride;
+            std::tie(n_iters, secondary_stride) = leading_axis_lanes(ev);
 
             std::ptrdiff_t offset = 0;
 
@@ -59,6 +445,85 @@ namespace xt
             }
         }
 
+        // execution policy whose grain size is expressed in lanes of lane_size elements
+        inline execution::execution_policy lane_policy(std::size_t lane_size)
+        {
+            const execution::execution_policy& policy = execution::default_policy();
+            return policy.with_grain_size(policy.grain_size() / (std::max)(lane_size, std::size_t(1)));
+        }
+
+        /**
+         * Calls fct over the lanes of the leading axis of ev, like call_over_leading_axis,
+         * but distributes the lanes over the threads of the current execution policy.
+         * fct must be safe to call concurrently on different lanes.
+         */
+        template <class E, class F>
+        inline void parallel_call_over_leading_axis(E& ev, F&& fct)
+        {
+            std::size_t n_iters;
+            std::ptrdiff_t secondary_stride;
+            std::tie(n_iters, secondary_stride) = leading_axis_lanes(ev);
+
+            auto data = ev.data();
+            execution::parallel_for(lane_policy(static_cast<std::size_t>(secondary_stride)), 0, n_iters,
+                                    [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    auto lane = data + static_cast<std::ptrdiff_t>(i) * secondary_stride;
+                    fct(lane, lane + secondary_stride);
+                }
+            });
+        }
+
+        /**
+         * Sorts [first, last) with the threads of the current execution policy:
+         * runs of at least the grain size are sorted independently, then merged
+         * pairwise. The result is the same as the one of std::sort.
+         */
+        template <class It, class C>
+        inline void parallel_sort(It first, It last, C comp)
+        {
+            const execution::execution_policy& policy = execution::default_policy();
+            const std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+            const std::size_t grain = policy.grain_size();
+            if (!policy.is_parallel() || size < 2 * grain)
+            {
+                sort_range(first, last, comp);
+                return;
+            }
+
+            std::size_t nb_runs = (std::min)(size / grain, 4 * execution::detail::backend_concurrency());
+            const std::size_t run_size = (size + nb_runs - 1) / nb_runs;
+            nb_runs = (size + run_size - 1) / run_size;
+            auto at = [first](std::size_t i) { return first + static_cast<std::ptrdiff_t>(i); };
+
+            execution::parallel_for(policy.with_grain_size(1), 0, nb_runs, [&](std::size_t run_first, std::size_t run_last)
+            {
+                for (std::size_t r = run_first; r < run_last; ++r)
+                {
+                    sort_range(at(r * run_size), at((std::min)((r + 1) * run_size, size)), comp);
+                }
+            });
+
+            for (std::size_t width = run_size; width < size; width *= 2)
+            {
+                std::size_t nb_merges = (size + 2 * width - 1) / (2 * width);
+                execution::parallel_for(policy.with_grain_size(1), 0, nb_merges, [&](std::size_t merge_first, std::size_t merge_last)
+                {
+                    for (std::size_t m = merge_first; m < merge_last; ++m)
+                    {
+                        std::size_t begin = m * 2 * width;
+                        std::size_t middle = begin + width;
+                        if (middle < size)
+                        {
+                            std::inplace_merge(at(begin), at(middle), at((std::min)(middle + width, size)), comp);
+                        }
+                    }
+                });
+            }
+        }
+
         template <class E>
         inline std::size_t leading_axis(const E& e)
         {
@@ -110,13 +575,13 @@ namespace xt
                 std::tie(permutation, reverse_permutation) = get_permutations(e.dimension(), axis, e.layout());
 
                 res = transpose(e, permutation);
-                detail::call_over_leading_axis(res, std::forward<F>(lambda));
+                detail::parallel_call_over_leading_axis(res, std::forward<F>(lambda));
                 res = transpose(res, reverse_permutation);
             }
             else
             {
                 res = e;
-                detail::call_over_leading_axis(res, std::forward<F>(lambda));
+                detail::parallel_call_over_leading_axis(res, std::forward<F>(lambda));
             }
         }
 
@@ -155,7 +620,7 @@ namespace xt
             ev.resize({de.size()});
 
             std::copy(de.cbegin(), de.cend(), ev.begin());
-            std::sort(ev.begin(), ev.end());
+            detail::parallel_sort(ev.data(), ev.data() + ev.size(), nan_last_less());
 
             return ev;
         }
@@ -184,7 +649,11 @@ namespace xt
 
     /**
      * Sort xexpression (optionally along axis)
-     * The sort is performed using the ``std::sort`` functions.
+     * The sort is performed using the ``std::sort`` functions, or a radix sort
+     * for arithmetic value types above ``XTENSOR_RADIX_SORT_THRESHOLD``
+     * elements; in both cases NaNs are sorted last. The lanes along
+     * the axis (or the runs of a 1-D expression) are distributed over the threads
+     * of the current execution policy.
      * A copy of the xexpression is created and returned.
      *
      * @param e xexpression to sort
@@ -207,7 +676,7 @@ namespace xt
         std::size_t ax = normalize_axis(de.dimension(), axis);
 
         eval_type res;
-        detail::run_lambda_over_axis(de, res, ax, [](auto begin, auto end) { std::sort(begin, end); });
+        detail::run_lambda_over_axis(de, res, ax, [](auto begin, auto end) { detail::sort_range(begin, end); });
         return res;
     }
 
@@ -270,7 +739,7 @@ namespace xt
         };
 
         template <class Ed, class Ei>
-        inline void argsort_over_leading_axis(const Ed& data, Ei& inds)
+        inline void argsort_over_leading_axis(const Ed& data, Ei& inds, sorting_method method)
         {
             std::size_t n_iters = 1;
             std::ptrdiff_t data_secondary_stride, inds_secondary_stride;
@@ -290,45 +759,76 @@ namespace xt
                 inds_secondary_stride = inds.shape(0);
             }
 
-            auto ptr = data.data();
-            auto indices_ptr = inds.data();
+            auto data_ptr = data.data();
+            auto inds_ptr = inds.data();
 
-            for (std::size_t i = 0; i < n_iters; ++i, ptr += data_secondary_stride, indices_ptr += inds_secondary_stride)
+            execution::parallel_for(lane_policy(static_cast<std::size_t>(data_secondary_stride)), 0, n_iters,
+                                    [&](std::size_t first, std::size_t last)
             {
-                auto comp = [&ptr](std::size_t x, std::size_t y) {
-                    return *(ptr + x) < *(ptr + y);
-                };
-                std::iota(indices_ptr, indices_ptr + inds_secondary_stride, 0);
-                std::sort(indices_ptr, indices_ptr + inds_secondary_stride, comp);
-            }
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    auto ptr = data_ptr + static_cast<std::ptrdiff_t>(i) * data_secondary_stride;
+                    auto indices_ptr = inds_ptr + static_cast<std::ptrdiff_t>(i) * inds_secondary_stride;
+                    argsort_range(ptr, indices_ptr, static_cast<std::size_t>(inds_secondary_stride), method);
+                }
+            });
         }
 
-        template <class E, class R = typename detail::linear_argsort_result_type<E>::type>
-        inline auto flatten_argsort_impl(const xexpression<E>& e)
+        template <class E, class R>
+        inline void flatten_argsort_impl(const E& de, R& result, sorting_method method, std::false_type /*radix sortable*/)
         {
-            const auto& de = e.derived_cast();
-
             auto cit = de.template begin<layout_type::row_major>();
             using const_iterator = decltype(cit);
             auto ad = xiterator_adaptor<const_iterator, const_iterator>(cit, cit, de.size());
 
-            using result_type = R;
-            result_type result;
-            result.resize({de.size()});
             auto comp = [&ad](std::size_t x, std::size_t y) {
-                return ad[x] < ad[y];
+                return nan_last_less()(ad[x], ad[y]);
             };
             std::iota(result.begin(), result.end(), 0);
-            std::sort(result.begin(), result.end(), comp);
+            if (method == sorting_method::stable)
+            {
+                std::stable_sort(result.begin(), result.end(), comp);
+            }
+            else
+            {
+                std::sort(result.begin(), result.end(), comp);
+            }
+        }
+
+        template <class E, class R>
+        inline void flatten_argsort_impl(const E& de, R& result, sorting_method method, std::true_type /*radix sortable*/)
+        {
+            if (use_radix_sort<typename E::value_type>(de.size()))
+            {
+                uvector<typename E::value_type> values(de.size());
+                std::copy(de.template cbegin<layout_type::row_major>(), de.template cend<layout_type::row_major>(), values.begin());
+                radix_argsort(values.data(), result.data(), values.size());
+            }
+            else
+            {
+                flatten_argsort_impl(de, result, method, std::false_type());
+            }
+        }
+
+        template <class E, class R = typename detail::linear_argsort_result_type<E>::type>
+        inline auto flatten_argsort_impl(const xexpression<E>& e, sorting_method method)
+        {
+            const auto& de = e.derived_cast();
+
+            using result_type = R;
+            result_type result;
+            result.resize({de.size()});
+            flatten_argsort_impl(de, result, method, typename is_radix_sortable<typename E::value_type>::type());
 
             return result;
         }
     }
 
     template <class E>
-    inline auto argsort(const xexpression<E>& e, placeholders::xtuph /*t*/)
+    inline auto argsort(const xexpression<E>& e, placeholders::xtuph /*t*/,
+                        sorting_method method = sorting_method::quick)
     {
-        return detail::flatten_argsort_impl(e);
+        return detail::flatten_argsort_impl(e, method);
     }
 
     /**
@@ -337,13 +837,19 @@ namespace xt
      * of indices of the same shape as e that index data along the given axis in
      * sorted order.
      *
+     * Arithmetic value types use a (stable) radix sort when the lanes hold at
+     * least ``XTENSOR_RADIX_SORT_THRESHOLD`` elements. NaNs are sorted last
+     * whatever the size of the lanes.
+     *
      * @param e xexpression to argsort
      * @param axis axis along which argsort is performed
+     * @param method sorting algorithm to use
      *
      * @return argsorted index array
      */
     template <class E>
-    inline auto argsort(const xexpression<E>& e, std::ptrdiff_t axis = -1)
+    inline auto argsort(const xexpression<E>& e, std::ptrdiff_t axis = -1,
+                        sorting_method method = sorting_method::quick)
     {
         using eval_type = typename detail::sort_eval_type<E>::type;
         using result_type = typename detail::argsort_result_type<eval_type>::type;
@@ -354,7 +860,7 @@ namespace xt
 
         if (de.dimension() == 1)
         {
-            return detail::flatten_argsort_impl<E, result_type>(e);
+            return detail::flatten_argsort_impl<E, result_type>(e, method);
         }
 
         if (ax != detail::leading_axis(de))
@@ -364,26 +870,92 @@ namespace xt
 
             eval_type ev = transpose(de, permutation);
             result_type res = result_type::from_shape(ev.shape());
-            detail::argsort_over_leading_axis(ev, res);
+            detail::argsort_over_leading_axis(ev, res, method);
             res = transpose(res, reverse_permutation);
             return res;
         }
         else
         {
             result_type res = result_type::from_shape(de.shape());
-            detail::argsort_over_leading_axis(de, res);
+            detail::argsort_over_leading_axis(de, res, method);
             return res;
         }
     }
 
-    /************************************************
-     * Implementation of partition and argpartition *
-     ************************************************/
+    /***********
+     * lexsort *
+     ***********/
+
+    namespace detail
+    {
+        /**
+         * Stably reorders indices according to the values of key at these
+         * indices. Only the values of the current key are gathered, the
+         * order given by the previous keys is kept by the stability.
+         */
+        template <class E>
+        inline void lexsort_pass(const E& key, uvector<std::size_t>& indices, uvector<std::size_t>& buffer)
+        {
+            using value_type = typename E::value_type;
+
+            if (key.dimension() != 1 || key.size() != indices.size())
+            {
+                XTENSOR_THROW(std::runtime_error, "lexsort: keys must be 1-D expressions of the same size.");
+            }
+
+            auto&& ev = eval(key);
+            std::size_t n = indices.size();
+            uvector<value_type> gathered(n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                gathered[i] = ev(indices[i]);
+            }
+
+            argsort_range(gathered.data(), buffer.data(), n, sorting_method::stable);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                buffer[i] = indices[buffer[i]];
+            }
+            std::swap(indices, buffer);
+        }
+    }
 
     /**
-     * Partially sort xexpression
+     * Indirect stable sort using a sequence of keys
+     * Returns the indices that sort the keys lexicographically, the last
+     * key being the primary sort key, the one before last the secondary,
+     * and so on (as numpy.lexsort). No composite key is built: the indices
+     * are stably sorted once per key, with a radix sort for arithmetic keys
+     * above ``XTENSOR_RADIX_SORT_THRESHOLD`` elements.
      *
-     * Partition shuffles the xexpression in a way so that the kth element
+     * @param keys 1-D xexpressions of the same size
+     *
+     * @return index array of the lexicographic order
+     */
+    template <class E, class... Es>
+    inline auto lexsort(const xexpression<E>& key, const xexpression<Es>&... keys)
+    {
+        std::size_t n = key.derived_cast().size();
+        uvector<std::size_t> indices(n);
+        uvector<std::size_t> buffer(n);
+        std::iota(indices.begin(), indices.end(), std::size_t(0));
+
+        xt::for_each([&indices, &buffer](const auto& k) { detail::lexsort_pass(k, indices, buffer); },
+                     std::forward_as_tuple(key.derived_cast(), keys.derived_cast()...));
+
+        xtensor<std::size_t, 1> result = xtensor<std::size_t, 1>::from_shape({n});
+        std::copy(indices.cbegin(), indices.cend(), result.begin());
+        return result;
+    }
+
+    /************************************************
+     * Implementation of partition and argpartition *
+     ************************************************/
+
+    /**
+     * Partially sort xexpression
+     *
+     * Partition shuffles the xexpression in a way so that the kth element
      * in the returned xexpression is in the place it would appear in a sorted
      * array and all elements smaller than this entry are placed (unsorted) before.
      *
@@ -483,12 +1055,12 @@ namespace xt
         auto lambda = [&kth](auto begin, auto end) {
             std::nth_element(begin, begin + kth, end);
         };
-        detail::call_over_leading_axis(res, lambda);
+        detail::parallel_call_over_leading_axis(res, lambda);
 
         for (auto it = kth_copy.rbegin() + 1; it != kth_copy.rend(); ++it)
         {
             kth = *it;
-            detail::call_over_leading_axis(res, lambda);
+            detail::parallel_call_over_leading_axis(res, lambda);
         }
 
         if (!is_leading_axis)
@@ -785,83 +1357,469 @@ namespace xt
             return idx;
         }
 
-        template <layout_type L, class E, class F>
-        inline xtensor<std::size_t, 0> arg_func_impl(const E& e, F&& f)
+        template <class T>
+        struct use_simd_arg_func
+            : std::integral_constant<bool, has_simd_type<T>::value && std::is_arithmetic<T>::value &&
+                                               !std::is_same<T, bool>::value>
         {
-            return cmp_idx(e.template begin<L>(),
-                           e.template end<L>(), 1,
-                           std::forward<F>(f));
+        };
+
+        // number of simd batches compared per row of a contiguous sequence
+        constexpr std::size_t arg_func_simd_lanes = 4;
+
+        // number of rows processed with a comparison before the next one, for argminmax
+        constexpr std::size_t arg_func_chunk_rows = 64;
+
+        // the positions inside a block of rows must be exactly representable in T
+        template <class T>
+        constexpr std::size_t arg_func_block_rows() noexcept
+        {
+            return std::numeric_limits<T>::is_integer ?
+                (std::min)(static_cast<std::size_t>(std::numeric_limits<T>::max()), std::size_t(1) << 30) - 1 :
+                (std::size_t(1) << (std::min)(std::numeric_limits<T>::digits, 30)) - 1;
         }
 
-        template <layout_type L, class E, class F>
-        inline typename argfunc_result_type<E>::type
-        arg_func_impl(const E& e, std::size_t axis, F&& cmp)
+        /**
+         * Best values and their row indices for the columns of a block
+         * of rows, with respect to a comparison. block_idx holds the 1-based
+         * position of the best value in the current block of rows, as a T so
+         * that it can be updated with simd instructions.
+         */
+        template <class T, class C>
+        struct arg_func_state
+        {
+            arg_func_state(C c, std::size_t width)
+                : cmp(c), best(width), idx(width), block_idx(width)
+            {
+            }
+
+            C cmp;
+            uvector<T> best;
+            uvector<std::size_t> idx;
+            uvector<T> block_idx;
+        };
+
+        // Updates state with the rows [row_first, row_last), row k starting at first + k * row_stride
+        template <class T, class C>
+        inline void arg_func_update(const T* first, std::ptrdiff_t row_stride, std::size_t row_first,
+                                    std::size_t row_last, arg_func_state<T, C>& state, std::false_type /*simd*/)
+        {
+            std::size_t width = state.best.size();
+            T* best = state.best.data();
+            std::size_t* idx = state.idx.data();
+            for (std::size_t k = row_first; k < row_last; ++k)
+            {
+                const T* row = first + static_cast<std::ptrdiff_t>(k) * row_stride;
+                for (std::size_t j = 0; j < width; ++j)
+                {
+                    if (state.cmp(row[j], best[j]))
+                    {
+                        best[j] = row[j];
+                        idx[j] = k;
+                    }
+                }
+            }
+        }
+
+        template <class T, class C>
+        inline void arg_func_update(const T* first, std::ptrdiff_t row_stride, std::size_t row_first,
+                                    std::size_t row_last, arg_func_state<T, C>& state, std::true_type /*simd*/)
+        {
+            using batch_type = xt_simd::simd_type<T>;
+            constexpr std::size_t simd_size = xt_simd::simd_traits<T>::size;
+            constexpr std::size_t block_rows = arg_func_block_rows<T>();
+            std::size_t width = state.best.size();
+            std::size_t simd_end = width - width % simd_size;
+            T* best = state.best.data();
+            T* block_idx = state.block_idx.data();
+
+            for (std::size_t block_first = row_first; block_first < row_last; block_first += block_rows)
+            {
+                std::size_t block_last = (std::min)(block_first + block_rows, row_last);
+                std::fill(block_idx, block_idx + width, T(0));
+                for (std::size_t k = block_first; k < block_last; ++k)
+                {
+                    const T* row = first + static_cast<std::ptrdiff_t>(k) * row_stride;
+                    T rank = static_cast<T>(k - block_first + 1);
+                    batch_type rank_batch = xt_simd::set_simd<T, T>(rank);
+                    std::size_t j = 0;
+                    for (; j < simd_end; j += simd_size)
+                    {
+                        batch_type value = xt_simd::load_simd<T, T>(row + j, xt_simd::unaligned_mode());
+                        batch_type current = xt_simd::load_simd<T, T>(best + j, xt_simd::unaligned_mode());
+                        batch_type current_idx = xt_simd::load_simd<T, T>(block_idx + j, xt_simd::unaligned_mode());
+                        auto mask = state.cmp(value, current);
+                        xt_simd::store_simd<T, T>(best + j, xt_simd::select(mask, value, current), xt_simd::unaligned_mode());
+                        xt_simd::store_simd<T, T>(block_idx + j, xt_simd::select(mask, rank_batch, current_idx), xt_simd::unaligned_mode());
+                    }
+                    for (; j < width; ++j)
+                    {
+                        if (state.cmp(row[j], best[j]))
+                        {
+                            best[j] = row[j];
+                            block_idx[j] = rank;
+                        }
+                    }
+                }
+                for (std::size_t j = 0; j < width; ++j)
+                {
+                    if (block_idx[j] != T(0))
+                    {
+                        state.idx[j] = block_first + static_cast<std::size_t>(block_idx[j]) - 1;
+                    }
+                }
+            }
+        }
+
+        // Updates every state with the rows [row_first, row_last), by chunks so
+        // that the rows are still in cache for the next comparison.
+        template <class T, class S, class... C>
+        inline void arg_func_update_all(const T* first, std::ptrdiff_t row_stride, std::size_t row_first,
+                                        std::size_t row_last, S simd, arg_func_state<T, C>&... states)
+        {
+            for (std::size_t chunk = row_first; chunk < row_last; chunk += arg_func_chunk_rows)
+            {
+                std::size_t chunk_last = (std::min)(chunk + arg_func_chunk_rows, row_last);
+                auto dummy = {(arg_func_update(first, row_stride, chunk, chunk_last, states, simd), 0)...};
+                (void)dummy;
+            }
+        }
+
+        constexpr std::size_t arg_func_npos = std::numeric_limits<std::size_t>::max();
+
+        template <class T, class C>
+        inline void arg_func_seed(arg_func_state<T, C>& state, const T& value, std::size_t idx)
+        {
+            std::fill(state.best.begin(), state.best.end(), value);
+            std::fill(state.idx.begin(), state.idx.end(), idx);
+        }
+
+        // Flat index of the best value of a contiguous sequence, once its rows have been processed
+        template <class T, class C>
+        inline std::size_t arg_func_result(const T* first, std::size_t size, std::size_t rows, const arg_func_state<T, C>& state)
+        {
+            std::size_t width = state.best.size();
+            std::size_t result = 0;
+            T value = first[0];
+            // equivalent values: the first one in the sequence wins
+            for (std::size_t j = 0; j < width; ++j)
+            {
+                if (state.idx[j] != arg_func_npos)
+                {
+                    std::size_t flat = state.idx[j] * width + j;
+                    if (state.cmp(state.best[j], value) || (!state.cmp(value, state.best[j]) && flat < result))
+                    {
+                        value = state.best[j];
+                        result = flat;
+                    }
+                }
+            }
+            for (std::size_t i = rows * width; i < size; ++i)
+            {
+                if (state.cmp(first[i], value))
+                {
+                    value = first[i];
+                    result = i;
+                }
+            }
+            return result;
+        }
+
+        /**
+         * Indices of the best values of a contiguous sequence, one for each
+         * comparison. The sequence is processed as rows of width elements
+         * compared column-wise; all the columns are seeded with the first
+         * element so that the result matches a sequential scan: the first
+         * best element is selected and NaNs are skipped unless first.
+         */
+        template <class T, class S, class... C, std::size_t... I>
+        inline std::array<std::size_t, sizeof...(C)>
+        arg_func_contiguous(const T* first, std::size_t size, S simd,
+                            std::tuple<arg_func_state<T, C>...>& states, std::index_sequence<I...>)
+        {
+            std::size_t width = std::get<0>(states).best.size();
+            std::size_t rows = size / width;
+            auto seed = {(arg_func_seed(std::get<I>(states), first[0], arg_func_npos), 0)...};
+            (void)seed;
+            arg_func_update_all(first, static_cast<std::ptrdiff_t>(width), 0, rows, simd, std::get<I>(states)...);
+            return {{arg_func_result(first, size, rows, std::get<I>(states))...}};
+        }
+
+        // Indices of the best values of each column of a (rows, width) block, rows being axis_stride apart
+        template <class T, class S, class... C, std::size_t... I>
+        inline std::array<const std::size_t*, sizeof...(C)>
+        arg_func_vertical(const T* first, std::ptrdiff_t axis_stride, std::size_t axis_size, S simd,
+                          std::tuple<arg_func_state<T, C>...>& states, std::index_sequence<I...>)
+        {
+            auto seed = {(std::copy(first, first + std::get<I>(states).best.size(), std::get<I>(states).best.begin()),
+                          std::fill(std::get<I>(states).idx.begin(), std::get<I>(states).idx.end(), std::size_t(0)), 0)...};
+            (void)seed;
+            arg_func_update_all(first, axis_stride, 1, axis_size, simd, std::get<I>(states)...);
+            return {{std::get<I>(states).idx.data()...}};
+        }
+
+        template <class T, class... C, std::size_t... I>
+        inline std::array<std::size_t, sizeof...(C)>
+        arg_func_strided(const T* first, std::ptrdiff_t axis_stride, std::size_t axis_size,
+                         const std::tuple<C...>& cmp, std::index_sequence<I...>)
+        {
+            const T* last = first + static_cast<std::ptrdiff_t>(axis_size) * axis_stride;
+            return {{cmp_idx(first, last, axis_stride, std::get<I>(cmp))...}};
+        }
+
+        template <class T>
+        constexpr std::size_t arg_func_width(std::true_type /*simd*/) noexcept
+        {
+            return xt_simd::simd_traits<T>::size * arg_func_simd_lanes;
+        }
+
+        template <class T>
+        constexpr std::size_t arg_func_width(std::false_type /*simd*/) noexcept
+        {
+            return 1;
+        }
+
+        template <layout_type L, class E, class... C>
+        inline std::array<std::size_t, sizeof...(C)> arg_func_flat(const E& e, C... cmp)
         {
-            using eval_type = typename detail::sort_eval_type<E>::type;
             using value_type = typename E::value_type;
-            using result_type = typename argfunc_result_type<E>::type;
-            using result_shape_type = typename result_type::shape_type;
+            using simd = use_simd_arg_func<value_type>;
+
+            if (e.size() == 0)
+            {
+                XTENSOR_THROW(std::runtime_error, "argmin / argmax of an empty expression.");
+            }
+            if ((e.layout() == L || e.dimension() == 1) && e.is_contiguous())
+            {
+                constexpr std::size_t width = arg_func_width<value_type>(simd());
+                std::tuple<arg_func_state<value_type, C>...> states(arg_func_state<value_type, C>(cmp, width)...);
+                return arg_func_contiguous(e.data() + e.data_offset(), e.size(), simd(), states, std::index_sequence_for<C...>());
+            }
+            return {{cmp_idx(e.template begin<L>(), e.template end<L>(), 1, cmp)...}};
+        }
 
-            if (e.dimension() == 1)
+        /**
+         * Calls fct(data_offset, result_offset) for the positions
+         * [first, last) of a row-major traversal of shape, where the offsets
+         * are computed with data_strides and result_strides.
+         */
+        template <class F>
+        inline void arg_func_outer_loop(const std::vector<std::size_t>& shape,
+                                        const std::vector<std::ptrdiff_t>& data_strides,
+                                        const std::vector<std::ptrdiff_t>& result_strides,
+                                        std::size_t first, std::size_t last, F&& fct)
+        {
+            std::size_t n = shape.size();
+            std::vector<std::size_t> index(n);
+            std::ptrdiff_t data_offset = 0;
+            std::ptrdiff_t result_offset = 0;
+            std::size_t rem = first;
+            for (std::size_t i = n; i > 0; --i)
             {
-                return arg_func_impl<L>(e, std::forward<F>(cmp));
+                index[i - 1] = rem % shape[i - 1];
+                rem /= shape[i - 1];
+                data_offset += static_cast<std::ptrdiff_t>(index[i - 1]) * data_strides[i - 1];
+                result_offset += static_cast<std::ptrdiff_t>(index[i - 1]) * result_strides[i - 1];
             }
 
-            result_shape_type alt_shape;
-            xt::resize_container(alt_shape, e.dimension() - 1);
+            for (std::size_t o = first; o < last; ++o)
+            {
+                fct(data_offset, result_offset);
+                for (std::size_t i = n; i > 0; --i)
+                {
+                    if (++index[i - 1] < shape[i - 1])
+                    {
+                        data_offset += data_strides[i - 1];
+                        result_offset += result_strides[i - 1];
+                        break;
+                    }
+                    data_offset -= static_cast<std::ptrdiff_t>(shape[i - 1] - 1) * data_strides[i - 1];
+                    result_offset -= static_cast<std::ptrdiff_t>(shape[i - 1] - 1) * result_strides[i - 1];
+                    index[i - 1] = 0;
+                }
+            }
+        }
 
-            // Excluding copy, copy all of shape except for axis
-            std::copy(e.shape().cbegin(), e.shape().cbegin() + std::ptrdiff_t(axis), alt_shape.begin());
-            std::copy(e.shape().cbegin() + std::ptrdiff_t(axis) + 1, e.shape().cend(), alt_shape.begin() + std::ptrdiff_t(axis));
+        /**
+         * Indices of the best values along axis, one result per comparison.
+         * The input is traversed in place with its strides, without any copy:
+         * - if the axis is contiguous, each lane is scanned with arg_func_contiguous;
+         * - if another dimension is contiguous, the lanes along that dimension
+         *   are compared row by row (vertically) with simd instructions;
+         * - otherwise each lane is scanned with its stride.
+         * The outer positions are distributed over the threads of the current
+         * execution policy.
+         */
+        template <class E, class R, class... C>
+        inline void arg_func_axis(const E& e, std::size_t axis, std::array<R*, sizeof...(C)> results, C... cmp)
+        {
+            using value_type = typename E::value_type;
+            using simd = use_simd_arg_func<value_type>;
 
-            result_type result = result_type::from_shape(std::move(alt_shape));
-            auto result_iter = result.template begin<L>();
+            const std::size_t dim = e.dimension();
+            const std::size_t axis_size = e.shape()[axis];
+            const std::ptrdiff_t axis_stride = static_cast<std::ptrdiff_t>(e.strides()[axis]);
+            if (axis_size == 0)
+            {
+                XTENSOR_THROW(std::runtime_error, "argmin / argmax along an empty axis.");
+            }
+            if (results[0]->size() == 0)
+            {
+                return;
+            }
 
-            auto arg_func_lambda = [&result_iter, &cmp](auto begin, auto end) {
-                std::size_t idx = 0;
-                value_type val = *begin;
-                ++begin;
-                for (std::size_t i = 1; begin != end; ++begin, ++i)
+            // contiguous dimension of the lanes compared vertically, if any
+            std::size_t inner = dim;
+            if (axis_stride != 1 || axis_size == 1)
+            {
+                for (std::size_t d = 0; d < dim; ++d)
                 {
-                    if (cmp(*begin, val))
+                    if (d != axis && e.shape()[d] > 1 && e.strides()[d] == 1)
                     {
-                        val = *begin;
-                        idx = i;
+                        inner = d;
                     }
                 }
-                *result_iter = idx;
-                ++result_iter;
-            };
+            }
 
-            if (axis != detail::leading_axis(e))
+            std::vector<std::size_t> outer_shape;
+            std::vector<std::ptrdiff_t> data_strides;
+            std::vector<std::ptrdiff_t> result_strides;
+            std::ptrdiff_t inner_result_stride = 0;
+            for (std::size_t d = 0; d < dim; ++d)
             {
-                dynamic_shape<std::size_t> permutation, reverse_permutation;
-                std::tie(permutation, reverse_permutation) = detail::get_permutations(e.dimension(), axis, e.layout());
+                if (d == axis)
+                {
+                    continue;
+                }
+                std::ptrdiff_t result_stride = static_cast<std::ptrdiff_t>(results[0]->strides()[d < axis ? d : d - 1]);
+                if (d == inner)
+                {
+                    inner_result_stride = result_stride;
+                    continue;
+                }
+                outer_shape.push_back(e.shape()[d]);
+                data_strides.push_back(static_cast<std::ptrdiff_t>(e.strides()[d]));
+                result_strides.push_back(result_stride);
+            }
+            std::size_t outer_size = std::accumulate(outer_shape.cbegin(), outer_shape.cend(),
+                                                     std::size_t(1), std::multiplies<>());
+
+            const value_type* data = e.data();
+            std::array<std::size_t*, sizeof...(C)> result_data;
+            std::transform(results.begin(), results.end(), result_data.begin(), [](R* r) { return r->data(); });
+            auto store = [&result_data](std::ptrdiff_t result_offset, const std::array<std::size_t, sizeof...(C)>& idx) {
+                for (std::size_t i = 0; i < sizeof...(C); ++i)
+                {
+                    result_data[i][result_offset] = idx[i];
+                }
+            };
 
-                // note: creating copy
-                eval_type input = transpose(e, permutation);
-                detail::call_over_leading_axis(input, arg_func_lambda);
-                return result;
+            if (inner != dim)
+            {
+                const std::size_t width = e.shape()[inner];
+                const std::tuple<arg_func_state<value_type, C>...> prototype(arg_func_state<value_type, C>(cmp, width)...);
+                execution::parallel_for(lane_policy(width * axis_size), 0, outer_size,
+                                        [&](std::size_t first, std::size_t last)
+                {
+                    auto states = prototype;
+                    arg_func_outer_loop(outer_shape, data_strides, result_strides, first, last,
+                                        [&](std::ptrdiff_t data_offset, std::ptrdiff_t result_offset)
+                    {
+                        auto idx = arg_func_vertical(data + data_offset, axis_stride, axis_size, simd(),
+                                                     states, std::index_sequence_for<C...>());
+                        for (std::size_t i = 0; i < sizeof...(C); ++i)
+                        {
+                            for (std::size_t j = 0; j < width; ++j)
+                            {
+                                result_data[i][result_offset + static_cast<std::ptrdiff_t>(j) * inner_result_stride] = idx[i][j];
+                            }
+                        }
+                    });
+                });
+            }
+            else if (axis_stride == 1)
+            {
+                constexpr std::size_t width = arg_func_width<value_type>(simd());
+                const std::tuple<arg_func_state<value_type, C>...> prototype(arg_func_state<value_type, C>(cmp, width)...);
+                execution::parallel_for(lane_policy(axis_size), 0, outer_size,
+                                        [&](std::size_t first, std::size_t last)
+                {
+                    auto states = prototype;
+                    arg_func_outer_loop(outer_shape, data_strides, result_strides, first, last,
+                                        [&](std::ptrdiff_t data_offset, std::ptrdiff_t result_offset)
+                    {
+                        store(result_offset, arg_func_contiguous(data + data_offset, axis_size, simd(),
+                                                                 states, std::index_sequence_for<C...>()));
+                    });
+                });
             }
             else
             {
-                auto&& input = eval(e);
-                detail::call_over_leading_axis(input, arg_func_lambda);
-                return result;
+                const std::tuple<C...> cmps(cmp...);
+                execution::parallel_for(lane_policy(axis_size), 0, outer_size,
+                                        [&](std::size_t first, std::size_t last)
+                {
+                    arg_func_outer_loop(outer_shape, data_strides, result_strides, first, last,
+                                        [&](std::ptrdiff_t data_offset, std::ptrdiff_t result_offset)
+                    {
+                        store(result_offset, arg_func_strided(data + data_offset, axis_stride, axis_size,
+                                                              cmps, std::index_sequence_for<C...>()));
+                    });
+                });
             }
         }
+
+        template <layout_type L, class E, class F>
+        inline xtensor<std::size_t, 0> arg_func_impl(const E& e, F&& f)
+        {
+            return arg_func_flat<L>(e, std::forward<F>(f))[0];
+        }
+
+        template <class E, class... C>
+        inline std::array<typename argfunc_result_type<E>::type, sizeof...(C)>
+        arg_funcs_along_axis(const E& e, std::size_t axis, C... cmp)
+        {
+            using result_type = typename argfunc_result_type<E>::type;
+            using result_shape_type = typename result_type::shape_type;
+
+            result_shape_type alt_shape;
+            xt::resize_container(alt_shape, e.dimension() - 1);
+
+            // Excluding copy, copy all of shape except for axis
+            std::copy(e.shape().cbegin(), e.shape().cbegin() + std::ptrdiff_t(axis), alt_shape.begin());
+            std::copy(e.shape().cbegin() + std::ptrdiff_t(axis) + 1, e.shape().cend(), alt_shape.begin() + std::ptrdiff_t(axis));
+
+            std::array<result_type, sizeof...(C)> results;
+            std::array<result_type*, sizeof...(C)> result_ptrs;
+            for (std::size_t i = 0; i < sizeof...(C); ++i)
+            {
+                results[i].resize(alt_shape);
+                result_ptrs[i] = &results[i];
+            }
+            arg_func_axis(e, axis, result_ptrs, cmp...);
+            return results;
+        }
+
+        template <layout_type L, class E, class F>
+        inline typename argfunc_result_type<E>::type
+        arg_func_impl(const E& e, std::size_t axis, F&& cmp)
+        {
+            return std::move(arg_funcs_along_axis(e, axis, std::forward<F>(cmp))[0]);
+        }
     }
 
     template <layout_type L = XTENSOR_DEFAULT_TRAVERSAL, class E>
     inline auto argmin(const xexpression<E>& e)
     {
-        using value_type = typename E::value_type;
         auto&& ed = eval(e.derived_cast());
-        return detail::arg_func_impl<L>(ed, std::less<value_type>());
+        return detail::arg_func_impl<L>(ed, std::less<>());
     }
 
     /**
      * Find position of minimal value in xexpression
+     * The axis is traversed in place, without transposed copy; contiguous
+     * lanes are compared with simd instructions and the lanes are distributed
+     * over the threads of the current execution policy.
      *
      * @param e input xexpression
      * @param axis select axis (or none)
@@ -871,22 +1829,23 @@ namespace xt
     template <layout_type L = XTENSOR_DEFAULT_TRAVERSAL, class E>
     inline auto argmin(const xexpression<E>& e, std::ptrdiff_t axis)
     {
-        using value_type = typename E::value_type;
         auto&& ed = eval(e.derived_cast());
         std::size_t ax = normalize_axis(ed.dimension(), axis);
-        return detail::arg_func_impl<L>(ed, ax, std::less<value_type>());
+        return detail::arg_func_impl<L>(ed, ax, std::less<>());
     }
 
     template <layout_type L = XTENSOR_DEFAULT_TRAVERSAL, class E>
     inline auto argmax(const xexpression<E>& e)
     {
-        using value_type = typename E::value_type;
         auto&& ed = eval(e.derived_cast());
-        return detail::arg_func_impl<L>(ed, std::greater<value_type>());
+        return detail::arg_func_impl<L>(ed, std::greater<>());
     }
 
     /**
      * Find position of maximal value in xexpression
+     * The axis is traversed in place, without transposed copy; contiguous
+     * lanes are compared with simd instructions and the lanes are distributed
+     * over the threads of the current execution policy.
      *
      * @param e input xexpression
      * @param axis select axis (or none)
@@ -896,10 +1855,596 @@ namespace xt
     template <layout_type L = XTENSOR_DEFAULT_TRAVERSAL, class E>
     inline auto argmax(const xexpression<E>& e, std::ptrdiff_t axis)
     {
-        using value_type = typename E::value_type;
         auto&& ed = eval(e.derived_cast());
         std::size_t ax = normalize_axis(ed.dimension(), axis);
-        return detail::arg_func_impl<L>(ed, ax, std::greater<value_type>());
+        return detail::arg_func_impl<L>(ed, ax, std::greater<>());
+    }
+
+    /**
+     * Find positions of minimal and maximal values in xexpression
+     * Both positions are computed in a single traversal of the data.
+     *
+     * @param e input xexpression
+     *
+     * @return pair of the flat positions (in the L traversal order) of the
+     *         minimal and maximal values
+     */
+    template <layout_type L = XTENSOR_DEFAULT_TRAVERSAL, class E>
+    inline auto argminmax(const xexpression<E>& e)
+    {
+        auto&& ed = eval(e.derived_cast());
+        auto idx = detail::arg_func_flat<L>(ed, std::less<>(), std::greater<>());
+        return std::make_pair(xtensor<std::size_t, 0>(idx[0]), xtensor<std::size_t, 0>(idx[1]));
+    }
+
+    /**
+     * Find positions of minimal and maximal values along an axis
+     * Both results are computed in a single traversal of the data.
+     *
+     * @param e input xexpression
+     * @param axis select axis
+     *
+     * @return pair of xarrays with positions of minimal and maximal values
+     */
+    template <layout_type L = XTENSOR_DEFAULT_TRAVERSAL, class E>
+    inline auto argminmax(const xexpression<E>& e, std::ptrdiff_t axis)
+    {
+        auto&& ed = eval(e.derived_cast());
+        std::size_t ax = normalize_axis(ed.dimension(), axis);
+        auto results = detail::arg_funcs_along_axis(ed, ax, std::less<>(), std::greater<>());
+        return std::make_pair(std::move(results[0]), std::move(results[1]));
+    }
+
+    /********
+     * topk *
+     ********/
+
+    namespace detail
+    {
+        // lanes whose size is at least topk_heap_ratio * k use a bounded heap,
+        // the other ones a selection over a copy of the lane
+        constexpr std::size_t topk_heap_ratio = 8;
+
+        /**
+         * Orders the (value, index) pairs of a lane from the best to the worst
+         * candidate: by decreasing values if largest is true, by increasing
+         * values otherwise, equal values by increasing index.
+         */
+        template <class T>
+        struct topk_order
+        {
+            using pair_type = std::pair<T, std::size_t>;
+            bool largest;
+
+            bool better(const T& lhs, const T& rhs) const
+            {
+                return largest ? nan_last_less()(rhs, lhs) : nan_last_less()(lhs, rhs);
+            }
+
+            bool operator()(const pair_type& lhs, const pair_type& rhs) const
+            {
+                return better(lhs.first, rhs.first)
+                    || (!better(rhs.first, lhs.first) && lhs.second < rhs.second);
+            }
+        };
+
+        // keeps the k best values of the lane in a heap whose top is the worst of them
+        template <class T>
+        inline void topk_heap(const T* lane, std::ptrdiff_t stride, std::size_t size, std::size_t k, bool sorted,
+                              const topk_order<T>& order, std::vector<std::pair<T, std::size_t>>& buffer)
+        {
+            buffer.clear();
+            for (std::size_t i = 0; i < k; ++i)
+            {
+                buffer.emplace_back(lane[static_cast<std::ptrdiff_t>(i) * stride], i);
+            }
+            std::make_heap(buffer.begin(), buffer.end(), order);
+            for (std::size_t i = k; i < size; ++i)
+            {
+                // later indices lose ties, only strictly better values enter the heap
+                const T& value = lane[static_cast<std::ptrdiff_t>(i) * stride];
+                if (order.better(value, buffer.front().first))
+                {
+                    std::pop_heap(buffer.begin(), buffer.end(), order);
+                    buffer.back() = std::make_pair(value, i);
+                    std::push_heap(buffer.begin(), buffer.end(), order);
+                }
+            }
+            if (sorted)
+            {
+                std::sort_heap(buffer.begin(), buffer.end(), order);
+            }
+        }
+
+        // moves the k best values of the lane to the front of a copy with nth_element
+        template <class T>
+        inline void topk_select(const T* lane, std::ptrdiff_t stride, std::size_t size, std::size_t k, bool sorted,
+                                const topk_order<T>& order, std::vector<std::pair<T, std::size_t>>& buffer)
+        {
+            buffer.clear();
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                buffer.emplace_back(lane[static_cast<std::ptrdiff_t>(i) * stride], i);
+            }
+            auto kth = buffer.begin() + static_cast<std::ptrdiff_t>(k);
+            if (k < size)
+            {
+                std::nth_element(buffer.begin(), kth - 1, buffer.end(), order);
+            }
+            if (sorted)
+            {
+                std::sort(buffer.begin(), kth, order);
+            }
+        }
+
+        /**
+         * Fills values and indices with the k best elements of each lane along
+         * axis. The input is traversed in place with its strides, and the lanes
+         * are distributed over the threads of the current execution policy.
+         */
+        template <class E, class V, class I>
+        inline void topk_along_axis(const E& e, std::size_t axis, std::size_t k, bool largest, bool sorted,
+                                    V& values, I& indices)
+        {
+            using value_type = typename E::value_type;
+            using pair_type = std::pair<value_type, std::size_t>;
+
+            const std::size_t axis_size = e.shape()[axis];
+            const std::ptrdiff_t axis_stride = static_cast<std::ptrdiff_t>(e.strides()[axis]);
+            const std::ptrdiff_t result_axis_stride = static_cast<std::ptrdiff_t>(values.strides()[axis]);
+
+            std::vector<std::size_t> outer_shape;
+            std::vector<std::ptrdiff_t> data_strides;
+            std::vector<std::ptrdiff_t> result_strides;
+            for (std::size_t d = 0; d < e.dimension(); ++d)
+            {
+                if (d != axis)
+                {
+                    outer_shape.push_back(e.shape()[d]);
+                    data_strides.push_back(static_cast<std::ptrdiff_t>(e.strides()[d]));
+                    result_strides.push_back(static_cast<std::ptrdiff_t>(values.strides()[d]));
+                }
+            }
+            std::size_t outer_size = std::accumulate(outer_shape.cbegin(), outer_shape.cend(),
+                                                     std::size_t(1), std::multiplies<>());
+
+            const bool use_heap = k * topk_heap_ratio <= axis_size;
+            const topk_order<value_type> order = {largest};
+            const value_type* data = e.data();
+            auto values_data = values.data();
+            auto indices_data = indices.data();
+
+            execution::parallel_for(lane_policy(axis_size), 0, outer_size,
+                                    [&](std::size_t first, std::size_t last)
+            {
+                std::vector<pair_type> buffer;
+                buffer.reserve(use_heap ? k : axis_size);
+                arg_func_outer_loop(outer_shape, data_strides, result_strides, first, last,
+                                    [&](std::ptrdiff_t data_offset, std::ptrdiff_t result_offset)
+                {
+                    if (use_heap)
+                    {
+                        topk_heap(data + data_offset, axis_stride, axis_size, k, sorted, order, buffer);
+                    }
+                    else
+                    {
+                        topk_select(data + data_offset, axis_stride, axis_size, k, sorted, order, buffer);
+                    }
+                    for (std::size_t j = 0; j < k; ++j)
+                    {
+                        std::ptrdiff_t offset = result_offset + static_cast<std::ptrdiff_t>(j) * result_axis_stride;
+                        values_data[offset] = buffer[j].first;
+                        indices_data[offset] = buffer[j].second;
+                    }
+                });
+            });
+        }
+    }
+
+    /**
+     * Find the k largest (or smallest) elements along an axis
+     * Small values of k keep the best candidates of each lane in a bounded
+     * heap, larger ones select them with ``std::nth_element``. The lanes
+     * are distributed over the threads of the current execution policy.
+     * Equal values are returned by increasing index, and NaNs compare greater
+     * than any other value.
+     *
+     * @param e input xexpression
+     * @param k number of elements to return per lane
+     * @param axis axis along which the elements are selected
+     * @param largest return the largest elements if true, the smallest ones otherwise
+     * @param sorted return the elements from the best to the worst if true,
+     *               in an unspecified order otherwise
+     *
+     * @return pair of the values and of their indices along the axis, whose
+     *         shape is the shape of e with k elements along axis
+     */
+    template <class E>
+    inline auto topk(const xexpression<E>& e, std::size_t k, std::ptrdiff_t axis = -1,
+                     bool largest = true, bool sorted = true)
+    {
+        using value_result_type = typename detail::sort_eval_type<E>::type;
+        using index_result_type = typename detail::argsort_result_type<value_result_type>::type;
+
+        auto&& de = eval(e.derived_cast());
+        std::size_t ax = normalize_axis(de.dimension(), axis);
+        if (k > de.shape()[ax])
+        {
+            XTENSOR_THROW(std::runtime_error, "topk: k is larger than the size of the axis.");
+        }
+
+        typename value_result_type::shape_type shape;
+        xt::resize_container(shape, de.dimension());
+        std::copy(de.shape().cbegin(), de.shape().cend(), shape.begin());
+        shape[ax] = k;
+
+        value_result_type values;
+        index_result_type indices;
+        values.resize(shape);
+        indices.resize(shape);
+        if (values.size() != 0)
+        {
+            detail::topk_along_axis(de, ax, k, largest, sorted, values, indices);
+        }
+        return std::make_pair(std::move(values), std::move(indices));
+    }
+
+    /************
+     * quantile *
+     ************/
+
+    /**
+     * Interpolation used by quantile and nanquantile when a quantile lies
+     * between two elements i < j of the sorted lane, as in NumPy.
+     */
+    enum class quantile_method
+    {
+        /// i + (j - i) * fraction
+        linear,
+        /// i
+        lower,
+        /// j
+        higher,
+        /// (i + j) / 2
+        midpoint,
+        /// i or j, whichever is nearest (the even one for ties)
+        nearest
+    };
+
+    namespace detail
+    {
+        template <class T>
+        inline bool quantile_is_nan(const T& value, std::true_type /*is_floating_point*/)
+        {
+            return value != value;
+        }
+
+        template <class T>
+        inline bool quantile_is_nan(const T&, std::false_type /*is_floating_point*/)
+        {
+            return false;
+        }
+
+        // NumPy's lerp, exact at both ends of the interval
+        template <class R>
+        inline R quantile_lerp(R lhs, R rhs, R t)
+        {
+            R diff = rhs - lhs;
+            return t < R(0.5) ? lhs + diff * t : rhs - diff * (R(1) - t);
+        }
+
+        /**
+         * Positions lo <= hi in a sorted lane of size elements, and the
+         * interpolation weight t of hi, of the quantile q.
+         */
+        inline void quantile_weights(double q, std::size_t size, quantile_method method,
+                                     std::size_t& lo, std::size_t& hi, double& t)
+        {
+            double virtual_index = q * static_cast<double>(size - 1);
+            lo = (std::min)(static_cast<std::size_t>(virtual_index), size - 1);
+            double fraction = virtual_index - static_cast<double>(lo);
+            hi = fraction > 0. ? (std::min)(lo + 1, size - 1) : lo;
+            t = 0.;
+            switch (method)
+            {
+                case quantile_method::linear:
+                    t = fraction;
+                    break;
+                case quantile_method::lower:
+                    hi = lo;
+                    break;
+                case quantile_method::higher:
+                    lo = hi;
+                    break;
+                case quantile_method::midpoint:
+                    t = hi != lo ? 0.5 : 0.;
+                    break;
+                case quantile_method::nearest:
+                    lo = (fraction > 0.5 || (fraction == 0.5 && lo % 2 == 1)) ? hi : lo;
+                    hi = lo;
+                    break;
+            }
+        }
+
+        template <class Q>
+        inline std::vector<double> quantile_values(const Q& qs)
+        {
+            std::vector<double> res(qs.begin(), qs.end());
+            for (double q : res)
+            {
+                if (!(q >= 0. && q <= 1.))
+                {
+                    XTENSOR_THROW(std::runtime_error, "quantile: quantiles must be in the range [0, 1].");
+                }
+            }
+            return res;
+        }
+
+        /**
+         * Writes the quantiles qs of a lane to out. The lane is copied once,
+         * then the order statistics needed by all the quantiles are selected
+         * by increasing position with nth_element on shrinking ranges.
+         * A lane without any valid value, or with NaNs if skip_nan is false,
+         * gives NaN.
+         */
+        template <class T, class R>
+        inline void quantile_lane(const T* lane, std::ptrdiff_t stride, std::size_t size,
+                                  const std::vector<double>& qs, quantile_method method, bool skip_nan,
+                                  std::vector<T>& buffer, std::vector<std::size_t>& positions,
+                                  R* out, std::ptrdiff_t out_stride)
+        {
+            using is_float = typename std::is_floating_point<T>::type;
+
+            buffer.clear();
+            bool valid = true;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                const T& value = lane[static_cast<std::ptrdiff_t>(i) * stride];
+                if (quantile_is_nan(value, is_float()))
+                {
+                    if (!skip_nan)
+                    {
+                        valid = false;
+                        break;
+                    }
+                }
+                else
+                {
+                    buffer.push_back(value);
+                }
+            }
+            if (!valid || buffer.empty())
+            {
+                for (std::size_t j = 0; j < qs.size(); ++j)
+                {
+                    out[static_cast<std::ptrdiff_t>(j) * out_stride] = std::numeric_limits<R>::quiet_NaN();
+                }
+                return;
+            }
+
+            std::size_t lo, hi;
+            double t;
+            positions.clear();
+            for (double q : qs)
+            {
+                quantile_weights(q, buffer.size(), method, lo, hi, t);
+                positions.push_back(lo);
+                positions.push_back(hi);
+            }
+            std::sort(positions.begin(), positions.end());
+            positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+
+            // everything before first is already in place
+            auto first = buffer.begin();
+            for (std::size_t p : positions)
+            {
+                auto nth = buffer.begin() + static_cast<std::ptrdiff_t>(p);
+                if (nth == first)
+                {
+                    std::iter_swap(nth, std::min_element(nth, buffer.end()));
+                }
+                else
+                {
+                    std::nth_element(first, nth, buffer.end());
+                }
+                first = nth + 1;
+            }
+
+            for (std::size_t j = 0; j < qs.size(); ++j)
+            {
+                quantile_weights(qs[j], buffer.size(), method, lo, hi, t);
+                out[static_cast<std::ptrdiff_t>(j) * out_stride] =
+                    quantile_lerp(static_cast<R>(buffer[lo]), static_cast<R>(buffer[hi]), static_cast<R>(t));
+            }
+        }
+
+        template <class T>
+        using quantile_value_type_t = std::conditional_t<std::is_floating_point<T>::value, T, double>;
+
+        template <class E>
+        inline auto quantile_flat(const E& e, const std::vector<double>& qs, quantile_method method, bool skip_nan)
+        {
+            using value_type = typename E::value_type;
+            using result_type = xtensor<quantile_value_type_t<value_type>, 1>;
+
+            // the order of the elements does not matter, contiguous storage is read as is
+            result_type res = result_type::from_shape({qs.size()});
+            std::vector<value_type> buffer;
+            std::vector<std::size_t> positions;
+            buffer.reserve(e.size());
+            if (e.is_contiguous())
+            {
+                quantile_lane(e.data() + e.data_offset(), 1, e.size(), qs, method, skip_nan, buffer, positions, res.data(), 1);
+            }
+            else
+            {
+                std::vector<value_type> values(e.cbegin(), e.cend());
+                quantile_lane(values.data(), 1, values.size(), qs, method, skip_nan, buffer, positions, res.data(), 1);
+            }
+            return res;
+        }
+
+        template <class E, class Ev>
+        inline auto quantile_along_axis(const Ev& e, std::size_t axis, const std::vector<double>& qs,
+                                        quantile_method method, bool skip_nan)
+        {
+            using value_type = typename Ev::value_type;
+            using eval_type = typename sort_eval_type<E>::type;
+            using result_type = typename rebind_value_type<quantile_value_type_t<value_type>, eval_type>::type;
+
+            const std::size_t dim = e.dimension();
+            typename result_type::shape_type shape;
+            xt::resize_container(shape, dim);
+            shape[0] = qs.size();
+            std::copy(e.shape().cbegin(), e.shape().cbegin() + std::ptrdiff_t(axis), shape.begin() + 1);
+            std::copy(e.shape().cbegin() + std::ptrdiff_t(axis) + 1, e.shape().cend(), shape.begin() + std::ptrdiff_t(axis) + 1);
+            result_type res;
+            res.resize(shape);
+            if (res.size() == 0)
+            {
+                return res;
+            }
+
+            std::vector<std::size_t> outer_shape;
+            std::vector<std::ptrdiff_t> data_strides;
+            std::vector<std::ptrdiff_t> result_strides;
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                if (d != axis)
+                {
+                    outer_shape.push_back(e.shape()[d]);
+                    data_strides.push_back(static_cast<std::ptrdiff_t>(e.strides()[d]));
+                    result_strides.push_back(static_cast<std::ptrdiff_t>(res.strides()[d < axis ? d + 1 : d]));
+                }
+            }
+            std::size_t outer_size = std::accumulate(outer_shape.cbegin(), outer_shape.cend(),
+                                                     std::size_t(1), std::multiplies<>());
+
+            const std::size_t axis_size = e.shape()[axis];
+            const std::ptrdiff_t axis_stride = static_cast<std::ptrdiff_t>(e.strides()[axis]);
+            const std::ptrdiff_t q_stride = static_cast<std::ptrdiff_t>(res.strides()[0]);
+            const value_type* data = e.data();
+            auto res_data = res.data();
+
+            execution::parallel_for(lane_policy(axis_size), 0, outer_size,
+                                    [&](std::size_t first, std::size_t last)
+            {
+                std::vector<value_type> buffer;
+                std::vector<std::size_t> positions;
+                buffer.reserve(axis_size);
+                arg_func_outer_loop(outer_shape, data_strides, result_strides, first, last,
+                                    [&](std::ptrdiff_t data_offset, std::ptrdiff_t result_offset)
+                {
+                    quantile_lane(data + data_offset, axis_stride, axis_size, qs, method, skip_nan,
+                                  buffer, positions, res_data + result_offset, q_stride);
+                });
+            });
+            return res;
+        }
+    }
+
+    /**
+     * Compute quantiles of the flattened xexpression
+     * All the quantiles are computed from a single copy of the data, whose
+     * order statistics are selected with ``std::nth_element`` on shrinking
+     * ranges. The result is NaN if the expression is empty or holds NaNs.
+     *
+     * @param e input xexpression
+     * @param qs container of quantiles, in the range [0, 1]
+     * @param method interpolation method when a quantile lies between two elements
+     *
+     * @return 1-D xtensor holding one value per quantile, of type double
+     *         for integral value types
+     */
+    template <class E, class Q, class = std::enable_if_t<!std::is_arithmetic<Q>::value, int>>
+    inline auto quantile(const xexpression<E>& e, const Q& qs, quantile_method method = quantile_method::linear)
+    {
+        auto&& de = eval(e.derived_cast());
+        return detail::quantile_flat(de, detail::quantile_values(qs), method, false);
+    }
+
+    template <class E, std::size_t N>
+    inline auto quantile(const xexpression<E>& e, const double (&qs)[N], quantile_method method = quantile_method::linear)
+    {
+        return quantile(e, xtl::forward_sequence<std::array<double, N>, decltype(qs)>(qs), method);
+    }
+
+    /**
+     * Compute quantiles along an axis
+     * Each lane is copied once and all the quantiles are computed from that
+     * copy; the lanes are distributed over the threads of the current
+     * execution policy. The result of a lane is NaN if it is empty or holds NaNs.
+     *
+     * @param e input xexpression
+     * @param qs container of quantiles, in the range [0, 1]
+     * @param axis axis along which the quantiles are computed
+     * @param method interpolation method when a quantile lies between two elements
+     *
+     * @return array whose first dimension indexes the quantiles and whose other
+     *         dimensions are those of e without axis
+     */
+    template <class E, class Q, class = std::enable_if_t<!std::is_arithmetic<Q>::value, int>>
+    inline auto quantile(const xexpression<E>& e, const Q& qs, std::ptrdiff_t axis,
+                         quantile_method method = quantile_method::linear)
+    {
+        auto&& de = eval(e.derived_cast());
+        std::size_t ax = normalize_axis(de.dimension(), axis);
+        return detail::quantile_along_axis<E>(de, ax, detail::quantile_values(qs), method, false);
+    }
+
+    template <class E, std::size_t N>
+    inline auto quantile(const xexpression<E>& e, const double (&qs)[N], std::ptrdiff_t axis,
+                         quantile_method method = quantile_method::linear)
+    {
+        return quantile(e, xtl::forward_sequence<std::array<double, N>, decltype(qs)>(qs), axis, method);
+    }
+
+    /**
+     * Compute quantiles of the flattened xexpression, ignoring NaNs
+     * Same as quantile, except that NaNs are skipped; the result is NaN only
+     * if there is no other value.
+     *
+     * @param e input xexpression
+     * @param qs container of quantiles, in the range [0, 1]
+     * @param method interpolation method when a quantile lies between two elements
+     */
+    template <class E, class Q, class = std::enable_if_t<!std::is_arithmetic<Q>::value, int>>
+    inline auto nanquantile(const xexpression<E>& e, const Q& qs, quantile_method method = quantile_method::linear)
+    {
+        auto&& de = eval(e.derived_cast());
+        return detail::quantile_flat(de, detail::quantile_values(qs), method, true);
+    }
+
+    template <class E, std::size_t N>
+    inline auto nanquantile(const xexpression<E>& e, const double (&qs)[N], quantile_method method = quantile_method::linear)
+    {
+        return nanquantile(e, xtl::forward_sequence<std::array<double, N>, decltype(qs)>(qs), method);
+    }
+
+    /**
+     * Compute quantiles along an axis, ignoring NaNs
+     * Same as quantile, except that NaNs are skipped; the result of a lane
+     * is NaN only if it has no other value.
+     *
+     * @param e input xexpression
+     * @param qs container of quantiles, in the range [0, 1]
+     * @param axis axis along which the quantiles are computed
+     * @param method interpolation method when a quantile lies between two elements
+     */
+    template <class E, class Q, class = std::enable_if_t<!std::is_arithmetic<Q>::value, int>>
+    inline auto nanquantile(const xexpression<E>& e, const Q& qs, std::ptrdiff_t axis,
+                            quantile_method method = quantile_method::linear)
+    {
+        auto&& de = eval(e.derived_cast());
+        std::size_t ax = normalize_axis(de.dimension(), axis);
+        return detail::quantile_along_axis<E>(de, ax, detail::quantile_values(qs), method, true);
+    }
+
+    template <class E, std::size_t N>
+    inline auto nanquantile(const xexpression<E>& e, const double (&qs)[N], std::ptrdiff_t axis,
+                            quantile_method method = quantile_method::linear)
+    {
+        return nanquantile(e, xtl::forward_sequence<std::array<double, N>, decltype(qs)>(qs), axis, method);
     }
 
     /**
@@ -102,6 +102,22 @@
 #define XTENSOR_OPENMP_TRESHOLD 0
 #endif
 
+#ifndef XTENSOR_DEFAULT_GRAIN_SIZE
+#define XTENSOR_DEFAULT_GRAIN_SIZE 32768
+#endif
+
+#ifndef XTENSOR_RADIX_SORT_THRESHOLD
+#define XTENSOR_RADIX_SORT_THRESHOLD 4096
+#endif
+
+#ifndef XTENSOR_DEFAULT_EXECUTION_POLICY
+#if defined(XTENSOR_USE_TBB) || defined(XTENSOR_USE_OPENMP)
+#define XTENSOR_DEFAULT_EXECUTION_POLICY ::xt::execution::par
+#else
+#define XTENSOR_DEFAULT_EXECUTION_POLICY ::xt::execution::seq
+#endif
+#endif
+
 #ifndef XTENSOR_SELECT_ALIGN
 #define XTENSOR_SELECT_ALIGN(T) (XTENSOR_DEFAULT_ALIGNMENT != 0 ? XTENSOR_DEFAULT_ALIGNMENT : alignof(T))
 #endif
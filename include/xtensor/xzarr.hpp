@@ -0,0 +1,464 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_ZARR_HPP
+#define XTENSOR_ZARR_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <initializer_list>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "xarray.hpp"
+#include "xchunk_store.hpp"
+#include "xexecution.hpp"
+#include "xnoalias.hpp"
+#include "xnpy.hpp"
+#include "xstrided_view.hpp"
+#include "xtensor_config.hpp"
+
+namespace xt
+{
+
+    /****************************************
+     * load_zarr and dump_zarr declarations *
+     ****************************************/
+
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class C = xraw_codec>
+    xchunked_array<xchunk_file_store<T, L, C>>
+    load_zarr(const std::string& path, std::size_t pool_size = 1, bool prefetch = false, const C& codec = C());
+
+    template <layout_type L = XTENSOR_DEFAULT_LAYOUT, class E, class S, class C = xraw_codec>
+    void dump_zarr(const std::string& path, const xexpression<E>& e, const S& chunk_shape, const C& codec = C());
+
+    template <layout_type L = XTENSOR_DEFAULT_LAYOUT, class E, class I, class C = xraw_codec>
+    void dump_zarr(const std::string& path, const xexpression<E>& e, std::initializer_list<I> chunk_shape,
+                   const C& codec = C());
+
+    /*******************************************
+     * load_zarr and dump_zarr implementations *
+     *******************************************/
+
+    namespace detail
+    {
+        /**
+         * Returns the text of the value of a key of the top-level object of
+         * the JSON document json, or an empty string if the key is missing.
+         * Only the subset of JSON written in Zarr metadata is supported.
+         */
+        inline std::string zarr_value(const std::string& json, const std::string& key)
+        {
+            std::size_t depth = 0;
+            std::size_t pos = 0;
+            const std::string quoted_key = "\"" + key + "\"";
+            for (; pos < json.size(); ++pos)
+            {
+                char c = json[pos];
+                if (c == '{' || c == '[')
+                {
+                    ++depth;
+                }
+                else if (c == '}' || c == ']')
+                {
+                    --depth;
+                }
+                else if (c == '"')
+                {
+                    if (depth == 1 && json.compare(pos, quoted_key.size(), quoted_key) == 0)
+                    {
+                        pos += quoted_key.size();
+                        break;
+                    }
+                    pos = json.find('"', pos + 1);
+                    if (pos == std::string::npos)
+                    {
+                        return std::string();
+                    }
+                }
+            }
+
+            pos = json.find(':', pos);
+            if (pos == std::string::npos)
+            {
+                return std::string();
+            }
+            pos = json.find_first_not_of(" \t\r\n", pos + 1);
+            if (pos == std::string::npos)
+            {
+                return std::string();
+            }
+
+            std::size_t last = pos;
+            if (json[pos] == '"')
+            {
+                last = json.find('"', pos + 1);
+                last = last == std::string::npos ? json.size() : last + 1;
+            }
+            else if (json[pos] == '{' || json[pos] == '[')
+            {
+                std::size_t nested = 0;
+                for (; last < json.size(); ++last)
+                {
+                    char c = json[last];
+                    nested += (c == '{' || c == '[') ? 1u : 0u;
+                    nested -= (c == '}' || c == ']') ? 1u : 0u;
+                    if (nested == 0)
+                    {
+                        ++last;
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                last = json.find_first_of(",}\r\n", pos);
+                last = last == std::string::npos ? json.size() : last;
+                while (last > pos && (json[last - 1] == ' ' || json[last - 1] == '\t'))
+                {
+                    --last;
+                }
+            }
+            return json.substr(pos, last - pos);
+        }
+
+        inline std::string zarr_unquote(const std::string& value)
+        {
+            if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+            {
+                return value.substr(1, value.size() - 2);
+            }
+            return value;
+        }
+
+        inline std::vector<std::size_t> zarr_parse_shape(const std::string& value)
+        {
+            if (value.empty() || value.front() != '[')
+            {
+                XTENSOR_THROW(std::runtime_error, "zarr error: invalid shape in metadata: " + value);
+            }
+            std::vector<std::size_t> shape;
+            std::istringstream stream(value.substr(1));
+            char separator = ',';
+            while (separator == ',' && (stream >> std::ws) && stream.peek() != ']')
+            {
+                unsigned long long extent = 0;
+                stream >> extent >> std::ws >> separator;
+                if (!stream)
+                {
+                    XTENSOR_THROW(std::runtime_error, "zarr error: invalid shape in metadata: " + value);
+                }
+                shape.push_back(static_cast<std::size_t>(extent));
+            }
+            return shape;
+        }
+
+        template <class S>
+        inline std::string zarr_shape_string(const S& shape)
+        {
+            std::string res = "[";
+            for (std::size_t i = 0; i < shape.size(); ++i)
+            {
+                res += (i == 0 ? "" : ", ") + std::to_string(shape[i]);
+            }
+            return res + "]";
+        }
+
+        template <class T>
+        inline std::string zarr_fill_value(const T&, std::false_type /*is_arithmetic*/)
+        {
+            return "null";
+        }
+
+        template <class T>
+        inline std::string zarr_fill_value(const T& value, std::true_type /*is_arithmetic*/)
+        {
+            if (std::is_same<T, bool>::value)
+            {
+                return value ? "true" : "false";
+            }
+            if (std::is_integral<T>::value)
+            {
+                return std::is_signed<T>::value ? std::to_string(static_cast<long long>(value))
+                                                : std::to_string(static_cast<unsigned long long>(value));
+            }
+            if (std::isnan(static_cast<long double>(value)))
+            {
+                return "\"NaN\"";
+            }
+            if (std::isinf(static_cast<long double>(value)))
+            {
+                return value > T(0) ? "\"Infinity\"" : "\"-Infinity\"";
+            }
+            std::ostringstream stream;
+            stream << std::setprecision(std::numeric_limits<T>::max_digits10) << value;
+            return stream.str();
+        }
+
+        template <class T>
+        inline T zarr_parse_fill_value(const std::string&, std::false_type /*is_arithmetic*/)
+        {
+            return T();
+        }
+
+        template <class T>
+        inline T zarr_parse_fill_value(const std::string& value, std::true_type /*is_arithmetic*/)
+        {
+            if (value.empty() || value == "null")
+            {
+                return T();
+            }
+            if (value == "true" || value == "false")
+            {
+                return static_cast<T>(value == "true");
+            }
+            if (value == "\"NaN\"")
+            {
+                return static_cast<T>(std::numeric_limits<double>::quiet_NaN());
+            }
+            if (value == "\"Infinity\"" || value == "\"-Infinity\"")
+            {
+                double inf = std::numeric_limits<double>::infinity();
+                return static_cast<T>(value[1] == '-' ? -inf : inf);
+            }
+            std::istringstream stream(value);
+            if (std::is_integral<T>::value && value.front() == '-')
+            {
+                long long res = 0;
+                stream >> res;
+                return static_cast<T>(res);
+            }
+            else if (std::is_integral<T>::value)
+            {
+                unsigned long long res = 0;
+                stream >> res;
+                return static_cast<T>(res);
+            }
+            long double res = 0;
+            stream >> res;
+            return static_cast<T>(res);
+        }
+
+        inline std::string zarr_metadata_path(const std::string& path)
+        {
+            return path + "/.zarray";
+        }
+    }
+
+    /**
+     * Opens a Zarr v2 array stored in a directory.
+     *
+     * Only the ``.zarray`` metadata are read: the chunks are loaded lazily
+     * from their files in the pool of the returned chunked array, and the
+     * modified chunks are written back. The type and the memory order of the
+     * stored array must match T and L, and the compressor of the stored array
+     * must match the codec, filters are not supported.
+     *
+     * @param path The directory of the Zarr array
+     * @param pool_size The maximum number of chunks held in memory
+     * @param prefetch Whether the next chunk is loaded in the background
+     * @param codec The codec of the chunk files
+     * @tparam T The type of the elements of the stored array
+     * @tparam L The memory order of the chunks of the stored array
+     * @tparam C The codec of the chunk files, by default the chunks are not compressed
+     * @return a ``xchunked_array<xchunk_file_store<T, L, C>>`` on the stored array
+     * @sa dump_zarr
+     */
+    template <class T, layout_type L, class C>
+    inline xchunked_array<xchunk_file_store<T, L, C>>
+    load_zarr(const std::string& path, std::size_t pool_size, bool prefetch, const C& codec)
+    {
+        std::ifstream stream(detail::zarr_metadata_path(path));
+        if (!stream)
+        {
+            XTENSOR_THROW(std::runtime_error, "io error: failed to open file: " + detail::zarr_metadata_path(path));
+        }
+        std::stringstream buffer;
+        buffer << stream.rdbuf();
+        const std::string json = buffer.str();
+
+        if (detail::zarr_value(json, "zarr_format") != "2")
+        {
+            XTENSOR_THROW(std::runtime_error, "zarr error: only the version 2 of the format is supported");
+        }
+        std::string dtype = detail::zarr_unquote(detail::zarr_value(json, "dtype"));
+        if (dtype != detail::build_typestring<T>())
+        {
+            XTENSOR_THROW(std::runtime_error, "zarr error: formats not matching: " + dtype +
+                                              " vs " + detail::build_typestring<T>());
+        }
+        std::string order = detail::zarr_unquote(detail::zarr_value(json, "order"));
+        if (order != (L == layout_type::column_major ? "F" : "C"))
+        {
+            XTENSOR_THROW(std::runtime_error, "zarr error: memory order not matching: " + order);
+        }
+        std::string compressor = detail::zarr_value(json, "compressor");
+        std::string compressor_id = compressor == "null" ? std::string()
+                                                         : detail::zarr_unquote(detail::zarr_value(compressor, "id"));
+        if (compressor_id != codec.id())
+        {
+            XTENSOR_THROW(std::runtime_error, "zarr error: compressor not matching the codec: " + compressor);
+        }
+        std::string filters = detail::zarr_value(json, "filters");
+        if (!filters.empty() && filters != "null")
+        {
+            XTENSOR_THROW(std::runtime_error, "zarr error: filters are not supported");
+        }
+        std::string separator = detail::zarr_unquote(detail::zarr_value(json, "dimension_separator"));
+        if (!separator.empty() && separator != ".")
+        {
+            XTENSOR_THROW(std::runtime_error, "zarr error: unsupported dimension separator: " + separator);
+        }
+
+        using shape_type = std::vector<std::size_t>;
+        shape_type shape = detail::zarr_parse_shape(detail::zarr_value(json, "shape"));
+        shape_type chunk_shape = detail::zarr_parse_shape(detail::zarr_value(json, "chunks"));
+        if (shape.size() != chunk_shape.size())
+        {
+            XTENSOR_THROW(std::runtime_error, "zarr error: shape and chunks of different dimensions");
+        }
+        T fill_value = detail::zarr_parse_fill_value<T>(detail::zarr_value(json, "fill_value"), std::is_arithmetic<T>());
+        return chunked_file_array<T, L>(std::move(shape), std::move(chunk_shape), path, pool_size, prefetch,
+                                        fill_value, codec);
+    }
+
+    /**
+     * Stores an expression as a Zarr v2 array in a directory.
+     *
+     * The directory is created if it does not exist, and the ``.zarray``
+     * metadata are written along the files of the chunks. The chunks are
+     * computed and written in parallel with the current execution policy,
+     * the chunks at the border of the array being padded with zeros as
+     * required by the format.
+     *
+     * @param path The directory of the Zarr array
+     * @param e The expression to store
+     * @param chunk_shape The shape of a chunk
+     * @param codec The codec of the chunk files
+     * @tparam L The memory order of the chunks
+     * @tparam C The codec of the chunk files, by default the chunks are not compressed
+     * @sa load_zarr
+     */
+    template <layout_type L, class E, class S, class C>
+    inline void dump_zarr(const std::string& path, const xexpression<E>& e, const S& chunk_shape, const C& codec)
+    {
+        using value_type = typename E::value_type;
+        using chunk_type = xarray<value_type, L>;
+        using shape_type = std::vector<std::size_t>;
+        static_assert(std::is_trivially_copyable<value_type>::value, "dump_zarr requires trivially copyable elements");
+        static_assert(L == layout_type::row_major || L == layout_type::column_major,
+                      "dump_zarr requires a row_major or column_major layout");
+
+        const E& de = e.derived_cast();
+        const auto& shape = de.shape();
+        shape_type ch_shape(chunk_shape.begin(), chunk_shape.end());
+        if (ch_shape.size() != shape.size())
+        {
+            XTENSOR_THROW(std::runtime_error, "zarr error: chunk shape and shape of different dimensions");
+        }
+        shape_type grid_shape(shape.size());
+        for (std::size_t i = 0; i < shape.size(); ++i)
+        {
+            if (ch_shape[i] == 0)
+            {
+                XTENSOR_THROW(std::runtime_error, "zarr error: empty chunk shape");
+            }
+            grid_shape[i] = (static_cast<std::size_t>(shape[i]) + ch_shape[i] - 1) / ch_shape[i];
+        }
+
+        detail::make_directory(path);
+        {
+            std::ofstream stream(detail::zarr_metadata_path(path));
+            stream << "{\n"
+                   << "    \"chunks\": " << detail::zarr_shape_string(ch_shape) << ",\n"
+                   << "    \"compressor\": " << codec.config() << ",\n"
+                   << "    \"dimension_separator\": \".\",\n"
+                   << "    \"dtype\": \"" << detail::build_typestring<value_type>() << "\",\n"
+                   << "    \"fill_value\": " << detail::zarr_fill_value(value_type(), std::is_arithmetic<value_type>()) << ",\n"
+                   << "    \"filters\": null,\n"
+                   << "    \"order\": \"" << (L == layout_type::column_major ? "F" : "C") << "\",\n"
+                   << "    \"shape\": " << detail::zarr_shape_string(shape) << ",\n"
+                   << "    \"zarr_format\": 2\n"
+                   << "}\n";
+            if (!stream)
+            {
+                XTENSOR_THROW(std::runtime_error, "io error: failed to write file: " + detail::zarr_metadata_path(path));
+            }
+        }
+
+        // chunk files are named after their index in the grid, like in a file-backed chunked array
+        xchunk_file_store<value_type, L, C> names(path, ch_shape, 1, false, value_type(), codec);
+        names.resize(grid_shape);
+        const std::size_t grid_size = names.size();
+
+        // the views on e are built beforehand in the calling thread, so that the
+        // lazily computed shapes of e are not shared between threads
+        using view_type = decltype(strided_view(de, std::declval<xstrided_slice_vector>()));
+        std::vector<view_type> views;
+        std::vector<xstrided_slice_vector> chunk_slices(grid_size);
+        views.reserve(grid_size);
+        for (std::size_t index = 0; index < grid_size; ++index)
+        {
+            xstrided_slice_vector slices(shape.size());
+            xstrided_slice_vector& chunk_sv = chunk_slices[index];
+            chunk_sv.resize(shape.size());
+            std::size_t remainder = index;
+            for (std::size_t i = shape.size(); i != 0; --i)
+            {
+                std::size_t first = (remainder % grid_shape[i - 1]) * ch_shape[i - 1];
+                std::size_t last = (std::min)(first + ch_shape[i - 1], static_cast<std::size_t>(shape[i - 1]));
+                remainder /= grid_shape[i - 1];
+                slices[i - 1] = range(first, last);
+                chunk_sv[i - 1] = range(std::size_t(0), last - first);
+            }
+            views.push_back(strided_view(de, std::move(slices)));
+        }
+
+        execution::parallel_for(execution::default_policy().with_grain_size(1), 0, grid_size,
+                                [&](std::size_t first, std::size_t last)
+        {
+            chunk_type chunk = chunk_type::from_shape(ch_shape);
+            for (std::size_t index = first; index < last; ++index)
+            {
+                if (same_shape(views[index].shape(), ch_shape))
+                {
+                    noalias(chunk) = views[index];
+                }
+                else
+                {
+                    chunk.fill(value_type());
+                    strided_view(chunk, chunk_slices[index]) = views[index];
+                }
+
+                std::string chunk_path = names.chunk_path(index);
+                std::ofstream stream(chunk_path, std::ofstream::binary);
+                codec.encode(reinterpret_cast<const char*>(chunk.data()), chunk.size() * sizeof(value_type), stream);
+                if (!stream)
+                {
+                    XTENSOR_THROW(std::runtime_error, "io error: failed to write file: " + chunk_path);
+                }
+            }
+        });
+    }
+
+    template <layout_type L, class E, class I, class C>
+    inline void dump_zarr(const std::string& path, const xexpression<E>& e, std::initializer_list<I> chunk_shape,
+                          const C& codec)
+    {
+        dump_zarr<L>(path, e, std::vector<std::size_t>(chunk_shape.begin(), chunk_shape.end()), codec);
+    }
+}
+
+#endif
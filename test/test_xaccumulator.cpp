@@ -12,6 +12,7 @@
 #include "xtensor/xarray.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xbuilder.hpp"
+#include "xtensor/xexecution.hpp"
 #include "xtensor/xmanipulation.hpp"
 #include "xtensor/xmath.hpp"
 #include "xtensor/xrandom.hpp"
@@ -241,4 +242,93 @@ namespace xt
         auto result2 = xt::cumsum(a, 1);
         EXPECT_EQ(result2, expected);
     }
+
+    TEST(xaccumulator, parallel_scan)
+    {
+        xt::xarray<double> a = xt::arange<double>(5. * 7. * 300.).reshape({5, 7, 300});
+        xt::xarray<double, layout_type::column_major> ca = a;
+        xt::xarray<int> ia = xt::arange<int>(1000) % 7;
+        xt::xarray<double> b = 1. + xt::arange<double>(60.).reshape({3, 20}) / 100.;
+
+        std::vector<xt::xarray<double>> expected_a;
+        std::vector<xt::xarray<double, layout_type::column_major>> expected_ca;
+        for (std::ptrdiff_t axis = 0; axis < 3; ++axis)
+        {
+            expected_a.push_back(xt::cumsum(a, axis));
+            expected_ca.push_back(xt::cumsum(ca, axis));
+        }
+        xt::xarray<int> expected_ia = xt::cumsum(ia);
+        xt::xarray<double> expected_b = xt::cumprod(b, 1);
+        xt::xarray<double> expected_nb = xt::nancumsum(a, 2);
+
+        {
+            execution::scoped_policy guard(execution::par.with_grain_size(16));
+            for (std::ptrdiff_t axis = 0; axis < 3; ++axis)
+            {
+                EXPECT_EQ(xt::cumsum(a, axis), expected_a[std::size_t(axis)]);
+                EXPECT_EQ(xt::cumsum(ca, axis), expected_ca[std::size_t(axis)]);
+            }
+            EXPECT_EQ(xt::cumsum(ia), expected_ia);
+            EXPECT_EQ(xt::cumsum(ia, 0), expected_ia);
+            EXPECT_TRUE(xt::allclose(xt::cumprod(b, 1), expected_b));
+            EXPECT_EQ(xt::nancumsum(a, 2), expected_nb);
+        }
+
+        int sum = 0;
+        for (std::size_t i = 0; i < ia.size(); ++i)
+        {
+            sum += ia(i);
+            EXPECT_EQ(expected_ia(i), sum);
+        }
+    }
+
+    TEST(xaccumulator, parallel_scan_floating)
+    {
+        // long flat scans take the blocked three-phase path, which only
+        // reassociates the floating point operations
+        xt::random::seed(0);
+        xt::xarray<double> a = xt::random::rand<double>({5000}) - 0.5;
+        xt::xarray<float> fa = xt::cast<float>(a);
+        xt::xarray<double> b = 1. + (xt::random::rand<double>({5000}) - 0.5) / 1000.;
+        xt::xarray<double> c = xt::random::rand<double>({20, 30, 40});
+
+        xt::xarray<double> expected_a = xt::cumsum(a);
+        xt::xarray<float> expected_fa = xt::cumsum(fa);
+        xt::xarray<double> expected_b = xt::cumprod(b);
+        xt::xarray<double> expected_c = xt::cumsum(c);
+        xt::xarray<double> expected_pc = xt::cumprod(xt::flatten(c) / 2. + 0.75);
+
+        execution::scoped_policy guard(execution::par.with_grain_size(64));
+        EXPECT_TRUE(xt::allclose(xt::cumsum(a), expected_a, 1e-12, 1e-12));
+        EXPECT_TRUE(xt::allclose(xt::cumsum(a, 0), expected_a, 1e-12, 1e-12));
+        EXPECT_TRUE(xt::allclose(xt::cumsum(fa), expected_fa, 1e-3, 1e-3));
+        EXPECT_TRUE(xt::allclose(xt::cumprod(b), expected_b, 1e-10, 0.));
+        EXPECT_TRUE(xt::allclose(xt::cumsum(c), expected_c, 1e-12, 1e-12));
+        EXPECT_TRUE(xt::allclose(xt::cumprod(xt::flatten(c) / 2. + 0.75), expected_pc, 1e-10, 0.));
+    }
+
+    TEST(xaccumulator, compensated_cumsum)
+    {
+        const std::size_t n = 300000;
+        xt::xarray<float> a = xt::ones<float>({n}) * 0.1f;
+        auto res = xt::cumsum(a, summation::kahan);
+        EXPECT_NEAR(res(n - 1), double(n) * double(0.1f), 1e-6 * double(n) * double(0.1f));
+        EXPECT_NEAR(res(n / 2 - 1), double(n / 2) * double(0.1f), 1e-6 * double(n / 2) * double(0.1f));
+
+        xt::xarray<float> b = xt::ones<float>({std::size_t(2), n, std::size_t(3)}) * 0.1f;
+        xt::xarray<float, layout_type::column_major> cb = b;
+        auto rb = xt::cumsum(b, 1, summation::kahan);
+        auto rcb = xt::cumsum(cb, 1, summation::pairwise);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            EXPECT_NEAR(rb(1, n - 1, i), double(n) * double(0.1f), 1e-6 * double(n) * double(0.1f));
+            EXPECT_NEAR(rcb(1, n - 1, i), double(n) * double(0.1f), 1e-6 * double(n) * double(0.1f));
+        }
+
+        xt::xarray<int> c = {{1, 2, 3}, {4, 5, 6}};
+        xt::xarray<int> expected = {{1, 3, 6}, {4, 9, 15}};
+        EXPECT_EQ(xt::cumsum(c, 1, summation::kahan), expected);
+        xt::xarray<double> d = {{1, 2, 3}, {4, 5, 6}};
+        EXPECT_EQ(xt::cumsum(d, -1, summation::kahan), xt::cumsum(d, -1));
+    }
 }
@@ -12,7 +12,9 @@
 #include "xtensor/xtensor.hpp"
 
 #include "xtensor/xassign.hpp"
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xnoalias.hpp"
+#include "xtensor/xview.hpp"
 #include "test_common.hpp"
 
 #include <type_traits>
@@ -145,4 +147,25 @@ namespace xt
         }
 
     }
+
+    TEST(xassign, parallel_strided_assign)
+    {
+        using row_tensor = xt::xtensor<double, 3, xt::layout_type::row_major>;
+        using col_tensor = xt::xtensor<double, 3, xt::layout_type::column_major>;
+
+        col_tensor b = xt::arange<double>(6 * 7 * 9).reshape({6, 7, 9});
+        row_tensor expected = xt::zeros<double>({6, 7, 12});
+        row_tensor res = xt::zeros<double>({6, 7, 12});
+
+        xt::noalias(xt::view(expected, xt::all(), xt::all(), xt::range(2, 11)), xt::execution::seq) = 2. * b + 1.;
+        xt::noalias(xt::view(res, xt::all(), xt::all(), xt::range(2, 11)), xt::execution::par.with_grain_size(1)) = 2. * b + 1.;
+        EXPECT_EQ(res, expected);
+
+        col_tensor cexpected = xt::zeros<double>({6, 7, 12});
+        col_tensor cres = xt::zeros<double>({6, 7, 12});
+        row_tensor rb = b;
+        xt::noalias(xt::view(cexpected, xt::all(), xt::all(), xt::range(1, 10)), xt::execution::seq) = rb - b;
+        xt::noalias(xt::view(cres, xt::all(), xt::all(), xt::range(1, 10)), xt::execution::par.with_grain_size(1)) = rb - b;
+        EXPECT_EQ(cres, cexpected);
+    }
 }
@@ -0,0 +1,183 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "test_common_macros.hpp"
+
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xchunk_store.hpp"
+#include "xtensor/xexecution.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        template <class CS>
+        void remove_chunk_files(const xchunked_array<CS>& a)
+        {
+            for (std::size_t i = 0; i < a.grid_size(); ++i)
+            {
+                std::remove(a.chunks().chunk_path(i).c_str());
+            }
+        }
+    }
+
+    TEST(xchunk_store, assign_and_reload)
+    {
+        std::string directory = "xchunk_store_files";
+        std::vector<std::size_t> shape = {10, 10, 10};
+        std::vector<std::size_t> chunk_shape = {2, 3, 4};
+        xarray<double> b = arange(1000).reshape({10, 10, 10});
+
+        {
+            auto a = chunked_file_array<double>(shape, chunk_shape, directory, 2);
+            EXPECT_EQ(a.grid_size(), std::size_t(5 * 4 * 3));
+            EXPECT_EQ(a.chunks().pool_size(), std::size_t(2));
+            EXPECT_EQ(a.chunks().chunk_path(1), directory + "/0.0.1");
+
+            // chunks without file hold the fill value
+            EXPECT_EQ(a(9, 9, 9), 0.);
+
+            a = b;
+            EXPECT_EQ(a, b);
+            a += 1.;
+            EXPECT_EQ(a, b + 1.);
+            a(3, 9, 8) = -1.;
+            a.chunks().flush();
+
+            std::ifstream stream(a.chunks().chunk_path(0), std::ifstream::binary);
+            EXPECT_TRUE(bool(stream));
+        }
+
+        {
+            const auto a = chunked_file_array<double>(shape, chunk_shape, directory, 3, true);
+            xarray<double> expected = b + 1.;
+            expected(3, 9, 8) = -1.;
+            EXPECT_EQ(a, expected);
+
+            std::size_t nb_chunks = 0;
+            for (auto it = a.chunk_begin(); it != a.chunk_end(); ++it)
+            {
+                EXPECT_EQ((*it).shape(), a.chunk_shape());
+                ++nb_chunks;
+            }
+            EXPECT_EQ(nb_chunks, a.grid_size());
+            remove_chunk_files(a);
+        }
+        std::remove(directory.c_str());
+    }
+
+    TEST(xchunk_store, broadcast_assign)
+    {
+        std::string directory = "xchunk_store_broadcast_files";
+        std::vector<std::string> paths;
+        {
+            auto a = chunked_file_array<int, layout_type::column_major>({7, 5}, {3, 2}, directory, 1, false, 4);
+            EXPECT_EQ(a(6, 4), 4);
+
+            xarray<int> row = {1, 2, 3, 4, 5};
+            a = row;
+            EXPECT_EQ(a, broadcast(row, {7, 5}));
+
+            noalias(a) = 2 * a;
+            EXPECT_EQ(a, broadcast(2 * row, {7, 5}));
+
+            // the reversed rows would read chunks already overwritten
+            using namespace placeholders;
+            xarray<int> before = arange(35).reshape({7, 5});
+            a = before;
+            XT_EXPECT_THROW(a = view(a, range(_, _, -1)), std::runtime_error);
+            XT_EXPECT_THROW(a = 1 + view(a, range(_, _, -1), all()), std::runtime_error);
+            EXPECT_EQ(a, before);
+            a = view(before, range(_, _, -1));
+            EXPECT_EQ(a, view(before, range(_, _, -1)));
+
+            for (std::size_t i = 0; i < a.grid_size(); ++i)
+            {
+                paths.push_back(a.chunks().chunk_path(i));
+            }
+        }
+        for (const auto& path : paths)
+        {
+            std::remove(path.c_str());
+        }
+        std::remove(directory.c_str());
+    }
+
+    TEST(xchunk_store, file_backed_operand)
+    {
+        std::string directory = "xchunk_store_operand_files";
+        std::vector<std::size_t> shape = {12, 10};
+        std::vector<std::size_t> chunk_shape = {2, 2};
+        xarray<double> b = arange(120).reshape({12, 10});
+        {
+            auto a = chunked_file_array<double>(shape, chunk_shape, directory, 1);
+            const auto& ca = a;
+            a = b;
+
+            // elements are read by value, and references pin their chunk
+            EXPECT_EQ(ca(0, 0) + ca(11, 9), b(0, 0) + b(11, 9));
+            auto ref = a(0, 1);
+            a(11, 9) = -1.;
+            ref += 100.;
+            EXPECT_EQ(ca(0, 1), b(0, 1) + 100.);
+            EXPECT_EQ(ca(11, 9), -1.);
+            a(0, 1) = b(0, 1);
+            a(11, 9) = b(11, 9);
+
+            // the chunks of a outnumber its pool, so the expression is assigned serially
+            EXPECT_FALSE(detail::allows_parallel_chunk_assign<decltype(a + 1.)>::value);
+            execution::scoped_policy guard(execution::par.with_grain_size(1));
+            std::vector<std::size_t> c_chunk_shape = {3, 4};
+            auto c = chunked_array<double>(shape, c_chunk_shape);
+            noalias(c) = a + 1.;
+            EXPECT_EQ(c, b + 1.);
+            noalias(c) = 2. * a - c;
+            EXPECT_EQ(c, b - 1.);
+            EXPECT_EQ(a.chunks().pool_size(), std::size_t(1));
+
+            a.chunks().flush();
+            remove_chunk_files(a);
+        }
+        std::remove(directory.c_str());
+    }
+
+    TEST(xchunk_store, write_after_flush)
+    {
+        std::string directory = "xchunk_store_flush_files";
+        std::vector<std::size_t> shape = {4, 4};
+        std::vector<std::size_t> chunk_shape = {2, 2};
+        {
+            auto a = chunked_file_array<double>(shape, chunk_shape, directory, 1);
+            auto first = a(0, 0);
+            {
+                auto last = a(3, 3);
+                a.chunks().flush();
+                first = 1.;
+                last = 2.;
+            }
+            // evicts the chunk of last, first is written back by the destructor
+            const auto& ca = a;
+            EXPECT_EQ(ca(2, 0), 0.);
+        }
+        {
+            const auto a = chunked_file_array<double>(shape, chunk_shape, directory, 1);
+            EXPECT_EQ(a(0, 0), 1.);
+            EXPECT_EQ(a(3, 3), 2.);
+            remove_chunk_files(a);
+        }
+        std::remove(directory.c_str());
+    }
+}
@@ -12,6 +12,7 @@
 #include "xtensor/xbroadcast.hpp"
 #include "xtensor/xchunked_array.hpp"
 #include "xtensor/xcsv.hpp"
+#include "xtensor/xexecution.hpp"
 #include "xtensor/xnoalias.hpp"
 
 namespace xt
@@ -137,6 +138,25 @@ namespace xt
         EXPECT_EQ(a, b);
     }
 
+    TEST(xchunked_array, parallel_assign)
+    {
+        execution::scoped_policy guard(execution::par);
+        std::vector<std::size_t> shape = {17, 12, 9};
+        std::vector<std::size_t> chunk_shape = {4, 4, 4};
+        auto a = chunked_array<double>(shape, chunk_shape);
+        xt::xarray<double> b = arange(17 * 12 * 9).reshape({17, 12, 9});
+
+        // edge chunks are assigned through a view
+        a = 2. * b + 1.;
+        EXPECT_EQ(a, 2. * b + 1.);
+
+        noalias(a) = b;
+        EXPECT_EQ(a, b);
+
+        a += b;
+        EXPECT_EQ(a, 2. * b);
+    }
+
     TEST(xchunked_array, chunk_iterator)
     {
         std::vector<std::size_t> shape = {10, 10, 10};
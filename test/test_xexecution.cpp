@@ -0,0 +1,133 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "test_common_macros.hpp"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xeval.hpp"
+#include "xtensor/xexecution.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    TEST(xexecution, policy)
+    {
+        EXPECT_FALSE(execution::seq.is_parallel());
+        EXPECT_TRUE(execution::par.is_parallel());
+        EXPECT_TRUE(execution::par_unseq.is_parallel());
+
+        auto p = execution::par.with_grain_size(128).with_num_threads(3);
+        EXPECT_EQ(p.grain_size(), std::size_t(128));
+        EXPECT_EQ(p.num_threads(), std::size_t(3));
+        EXPECT_TRUE(p.type() == execution::policy_type::parallel);
+        EXPECT_FALSE(execution::par.with_num_threads(1).is_parallel());
+        EXPECT_EQ(execution::par.with_grain_size(0).grain_size(), std::size_t(1));
+    }
+
+    TEST(xexecution, scoped_policy)
+    {
+        execution::execution_policy previous = execution::default_policy();
+        {
+            execution::scoped_policy guard(execution::par.with_grain_size(7));
+            EXPECT_EQ(execution::default_policy().grain_size(), std::size_t(7));
+            EXPECT_TRUE(execution::default_policy().is_parallel());
+        }
+        EXPECT_EQ(execution::default_policy().grain_size(), previous.grain_size());
+        EXPECT_TRUE(execution::default_policy().type() == previous.type());
+    }
+
+    TEST(xexecution, parallel_for)
+    {
+        std::vector<int> hits(10000, 0);
+        execution::parallel_for(execution::par.with_grain_size(100), 0, hits.size(),
+                                [&hits](std::size_t first, std::size_t last)
+        {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                ++hits[i];
+            }
+        });
+        EXPECT_EQ(std::accumulate(hits.cbegin(), hits.cend(), 0), 10000);
+        EXPECT_EQ(*std::max_element(hits.cbegin(), hits.cend()), 1);
+
+        std::size_t nb_calls = 0;
+        execution::parallel_for(execution::seq.with_grain_size(1), 0, hits.size(),
+                                [&nb_calls](std::size_t, std::size_t) { ++nb_calls; });
+        EXPECT_EQ(nb_calls, std::size_t(1));
+
+        nb_calls = 0;
+        execution::parallel_for(execution::par, 0, 10, [&nb_calls](std::size_t, std::size_t) { ++nb_calls; });
+        EXPECT_EQ(nb_calls, std::size_t(1));
+    }
+
+    TEST(xexecution, thread_pool)
+    {
+        execution::xthread_pool pool(3);
+        EXPECT_EQ(pool.concurrency(), std::size_t(4));
+
+        std::vector<int> hits(1000, 0);
+        pool.run(hits.size(), [&hits](std::size_t i) { ++hits[i]; });
+        EXPECT_EQ(std::accumulate(hits.cbegin(), hits.cend(), 0), 1000);
+        EXPECT_EQ(*std::max_element(hits.cbegin(), hits.cend()), 1);
+
+        std::atomic<std::size_t> total(0);
+        pool.run(8, [&pool, &total](std::size_t)
+        {
+            pool.run(8, [&total](std::size_t) { ++total; });
+        });
+        EXPECT_EQ(total.load(), std::size_t(64));
+
+        XT_EXPECT_THROW(pool.run(100, [](std::size_t i)
+        {
+            if (i == 42)
+            {
+                throw std::runtime_error("task error");
+            }
+        }), std::runtime_error);
+    }
+
+    TEST(xexecution, noalias)
+    {
+        xarray<double> a = arange<double>(10000.);
+        xarray<double> b = 2. * a;
+        xarray<double> res1 = xarray<double>::from_shape({10000});
+        xarray<double> res2 = xarray<double>::from_shape({10000});
+
+        noalias(res1) = a + b;
+        noalias(res2, execution::par.with_grain_size(16)) = a + b;
+        EXPECT_EQ(res1, res2);
+
+        xtensor<int, 2> ta = {{1, 2, 3}, {4, 5, 6}};
+        xtensor<int, 2> tb = xtensor<int, 2>::from_shape({2, 3});
+        noalias(tb, execution::par.with_grain_size(1)) = ta;
+        EXPECT_EQ(ta, tb);
+        noalias(tb, execution::par.with_grain_size(1)) += ta;
+        EXPECT_EQ(xtensor<int, 2>(2 * ta), tb);
+    }
+
+    TEST(xexecution, eval_and_assign_data)
+    {
+        xarray<double> a = arange<double>(5000.);
+        auto&& res = eval(a * a + 1., execution::par.with_grain_size(8));
+        xarray<double> expected = a * a + 1.;
+        EXPECT_EQ(res, expected);
+
+        xarray<double> res2 = xarray<double>::from_shape({5000});
+        assign_data(res2, a * a + 1., true, execution::par_unseq.with_grain_size(8));
+        EXPECT_EQ(res2, expected);
+    }
+}
@@ -12,6 +12,7 @@
 
 #include "test_common_macros.hpp"
 #include "xtensor/xtensor.hpp"
+#include "xtensor/xexecution.hpp"
 #include "xtensor/xhistogram.hpp"
 #include "xtensor/xrandom.hpp"
 
@@ -70,6 +71,46 @@ namespace xt
         }
     }
 
+    TEST(xhistogram, parallel)
+    {
+        xt::random::seed(0);
+        xt::xtensor<double, 1> data = xt::random::randn<double>({10000});
+        data(0) = std::numeric_limits<double>::quiet_NaN();
+        data(1) = 3.;
+        xt::xtensor<double, 1> weights = xt::floor(xt::random::rand<double>({10000}) * 4.);
+        xt::xtensor<double, 1> edges = {-2., -1., -0.5, -0.5, 0., 0.3, 1., 3.};
+
+        // expected counts, with the upper edge included in the last bin
+        std::size_t n_bins = edges.size() - 1;
+        xt::xtensor<double, 1> expected = xt::zeros<double>({n_bins});
+        for (std::size_t i = 0; i < data.size(); ++i)
+        {
+            for (std::size_t b = 0; b < n_bins; ++b)
+            {
+                if (data(i) >= edges(b) && (data(i) < edges(b + 1) || (b == n_bins - 1 && data(i) == edges(b + 1))))
+                {
+                    expected(b) += weights(i);
+                    break;
+                }
+            }
+        }
+
+        xt::xtensor<double, 1> sequential = xt::histogram(data, edges, weights);
+        EXPECT_EQ(sequential, expected);
+        xt::xtensor<double, 1> uniform_sequential = xt::histogram(data, std::size_t(5), weights, -2., 3.);
+        xt::xtensor<double, 1> uniform_edges = {-2., -1., 0., 1., 2., 3.};
+        EXPECT_EQ(uniform_sequential, xt::histogram(data, uniform_edges, weights));
+        {
+            execution::scoped_policy guard(execution::par.with_grain_size(16));
+            xt::xtensor<double, 1> count = xt::histogram(data, edges, weights);
+            EXPECT_EQ(count, expected);
+            xt::xtensor<double, 1> uniform_count = xt::histogram(data, std::size_t(5), weights, -2., 3.);
+            EXPECT_EQ(uniform_count, uniform_sequential);
+            xt::xtensor<double, 1> lazy_count = xt::histogram(data * 1., edges, weights);
+            EXPECT_EQ(lazy_count, expected);
+        }
+    }
+
     TEST(xhistogram, bincount)
     {
         xtensor<int, 1> data = {1, 2, 3, 1, 1, 1, 1, 2, 3, 2, 3, 3, 3, 3};
@@ -13,6 +13,9 @@
 #include "xtensor/xrandom.hpp"
 #include "xtensor/xindex_view.hpp"
 #include "xtensor/xbroadcast.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xexecution.hpp"
+#include "xtensor/xoptional_assembly.hpp"
 #include "xtensor/xview.hpp"
 #include "test_common.hpp"
 
@@ -145,6 +148,60 @@ namespace xt
         EXPECT_EQ(expected, a);
     }
 
+    TEST(xindex_view, filtration_chunks)
+    {
+        execution::scoped_policy guard(execution::par.with_grain_size(7));
+        xarray<int> a = arange<int>(100).reshape({10, 10});
+        xarray<int> expected = where(a % 3 == 0, -1, a);
+        filtration(a, a % 3 == 0) = -1;
+        EXPECT_EQ(expected, a);
+    }
+
+    TEST(xindex_view, extract)
+    {
+        xarray<int> a = {{{1, 3}, {2, 4}}, {{5, 7}, {6, 8}}};
+        xarray<bool> cond = {{{true, true}, {false, false}}, {{true, true}, {false, false}}};
+
+        xtensor<int, 1> expr = {1, 3, 5, 7};
+        EXPECT_EQ(expr, extract(cond, a));
+        xtensor<int, 1> expc = {1, 5, 3, 7};
+        EXPECT_EQ(expc, extract<layout_type::column_major>(cond, a));
+        EXPECT_EQ(expr, extract(a == 1 || a % 2 == 1, a + 0));
+
+        EXPECT_EQ(size_t(0), extract(a > 10, a).size());
+        xarray<bool> bad_cond = {true, false};
+        XT_EXPECT_ANY_THROW(extract(bad_cond, a));
+
+        execution::scoped_policy guard(execution::par.with_grain_size(7));
+        xarray<double, layout_type::column_major> b = xt::random::rand<double>({20, 13});
+        xarray<double> filtered = filter(b, b > 0.3);
+        EXPECT_EQ(filtered, extract(b > 0.3, b));
+    }
+
+    TEST(xindex_view, extract_optional)
+    {
+        using opt_type = xoptional_assembly<xarray<double>, xarray<bool>>;
+        auto missing = xtl::missing<double>();
+        opt_type a = {{1., missing, 3.}, {missing, 5., 6.}};
+        xarray<bool> cond = {{true, true, false}, {false, true, true}};
+
+        auto res = extract(cond, a);
+        ASSERT_EQ(std::size_t(4), res.size());
+        EXPECT_EQ(1., res(0).value());
+        EXPECT_FALSE(res(1).has_value());
+        EXPECT_EQ(5., res(2).value());
+        EXPECT_EQ(6., res(3).value());
+
+        // missing conditions do not select, whatever the value under their flag
+        using opt_cond_type = xoptional_assembly<xarray<bool>, xarray<bool>>;
+        opt_cond_type ocond = {{true, xtl::missing<bool>(), false}, {false, true, xtl::missing<bool>()}};
+        ocond.value()(0, 1) = true;
+        ocond.value()(1, 2) = true;
+        xarray<double> b = {{1., 2., 3.}, {4., 5., 6.}};
+        xtensor<double, 1> expected = {1., 5.};
+        EXPECT_EQ(expected, extract(ocond, b));
+    }
+
     TEST(xindex_view, filter)
     {
         xarray<double> a = {{ 1, 5, 3 },{ 4, 5, 6 }};
@@ -16,6 +16,8 @@
 #include "xtensor/xoptional_assembly.hpp"
 #include "xtensor/xmath.hpp"
 #include "xtensor/xrandom.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -731,6 +733,33 @@ namespace xt
         EXPECT_TRUE(isclose(a, b, 1, 1, true)(0, 0));
     }
 
+    TEST(xmath, allclose_blocks)
+    {
+        xtensor<double, 2> a = xt::arange<double>(3000).reshape({3, 1000});
+        xtensor<double, 2> b = a + 1e-9;
+        EXPECT_TRUE(allclose(a, b));
+        b(2, 999) += 1.;
+        EXPECT_FALSE(allclose(a, b));
+        EXPECT_TRUE(allclose(a, b, 1e-05, 2.));
+
+        // operands that cannot be compared storage to storage
+        xarray<double, layout_type::column_major> c = a;
+        EXPECT_TRUE(allclose(a, c));
+        EXPECT_FALSE(allclose(c, b));
+        EXPECT_TRUE(allclose(transpose(a), transpose(c)));
+        EXPECT_FALSE(allclose(a, c + 1.));
+
+        // broadcasting
+        xtensor<double, 1> row = view(a, 0, all());
+        EXPECT_FALSE(allclose(a, row));
+        EXPECT_TRUE(allclose(view(a, range(0, 1), all()), row));
+
+        // NaN values are never close
+        b = a;
+        b(1, 500) = std::numeric_limits<double>::quiet_NaN();
+        EXPECT_FALSE(allclose(b, b));
+    }
+
     TEST(xmath, isclose_int)
     {
         EXPECT_FALSE(isclose(1, 2)());
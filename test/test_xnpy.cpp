@@ -10,10 +10,12 @@
 #include "test_common_macros.hpp"
 
 #include "xtensor/xnpy.hpp"
+#include "xtensor/xnpy_mmap.hpp"
 #include "xtensor/xarray.hpp"
 
 #include <fstream>
 #include <cstdint>
+#include <type_traits>
 
 namespace xt
 {
@@ -158,4 +160,43 @@ namespace xt
         xarray<char> adc = dc;
         EXPECT_EQ(adc(0, 0), 0);
     }
+
+    TEST(xnpy, mmap)
+    {
+        auto darr_loaded = load_npy<double>(get_load_filename("files/xnpy_files/double"));
+        auto darr_mapped = mmap_npy<double>(get_load_filename("files/xnpy_files/double"));
+        EXPECT_EQ(darr_loaded.shape(), darr_mapped.shape());
+        EXPECT_TRUE(all(equal(darr_loaded, darr_mapped)));
+        bool read_only_is_const = std::is_same<decltype(darr_mapped(0, 0)), const double&>::value;
+        EXPECT_TRUE(read_only_is_const);
+
+        auto dfarr_loaded = load_npy<double, layout_type::column_major>(get_load_filename("files/xnpy_files/double_fortran"));
+        auto dfarr_mapped = mmap_npy<double, layout_type::column_major>(get_load_filename("files/xnpy_files/double_fortran"));
+        EXPECT_EQ(dfarr_mapped.layout(), layout_type::column_major);
+        EXPECT_TRUE(all(equal(dfarr_loaded, dfarr_mapped)));
+
+        auto barr_mapped = mmap_npy<bool>(get_load_filename("files/xnpy_files/bool"));
+        EXPECT_TRUE(all(equal(load_npy<bool>(get_load_filename("files/xnpy_files/bool")), barr_mapped)));
+
+        XT_EXPECT_ANY_THROW(mmap_npy<float>(get_load_filename("files/xnpy_files/double")));
+        XT_EXPECT_ANY_THROW(mmap_npy<double, layout_type::column_major>(get_load_filename("files/xnpy_files/double")));
+
+        std::string filename = get_dump_filename(2);
+        xtensor<int, 2> iarr = {{1, 2, 3}, {4, 5, 6}};
+        dump_npy(filename, iarr);
+        {
+            auto private_map = mmap_npy<int>(filename, mmap_mode::copy_on_write);
+            bool copy_on_write_is_mutable = std::is_same<decltype(private_map(0, 0)), int&>::value;
+            EXPECT_TRUE(copy_on_write_is_mutable);
+            private_map(0, 0) = 42;
+            EXPECT_EQ(private_map(0, 0), 42);
+        }
+        EXPECT_EQ(load_npy<int>(filename)(0, 0), 1);
+        {
+            auto shared_map = mmap_npy<int>(filename, mmap_mode::read_write);
+            shared_map(1, 2) = 42;
+        }
+        EXPECT_EQ(load_npy<int>(filename)(1, 2), 42);
+        std::remove(filename.c_str());
+    }
 }
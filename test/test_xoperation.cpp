@@ -14,8 +14,10 @@
 #include <cstddef>
 
 #include "xtensor/xarray.hpp"
+#include "xtensor/xmanipulation.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xoptional_assembly.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -585,6 +587,105 @@ namespace xt
             EXPECT_EQ(last_idx, d_nz.back());
         }
 
+        TEST_CASE("nonzero_chunks")
+        {
+            // small grain size so that the rows are split between several chunks
+            execution::scoped_policy guard(execution::par.with_grain_size(7));
+
+            auto a = xarray<int, layout_type::column_major>::from_shape({4, 9, 5});
+            for (std::size_t i = 0; i < a.size(); ++i)
+            {
+                a.flat(i) = (i * 7) % 3 == 0 ? 0 : int(i);
+            }
+
+            std::vector<std::vector<std::size_t>> expected(3);
+            std::vector<xindex_type_t<xarray<int>::shape_type>> expected_arg;
+            for (std::size_t i = 0; i < 4; ++i)
+            {
+                for (std::size_t j = 0; j < 9; ++j)
+                {
+                    for (std::size_t k = 0; k < 5; ++k)
+                    {
+                        if (a(i, j, k) != 0)
+                        {
+                            expected[0].push_back(i);
+                            expected[1].push_back(j);
+                            expected[2].push_back(k);
+                            expected_arg.push_back({i, j, k});
+                        }
+                    }
+                }
+            }
+
+            // column-major storage and lazy expressions are evaluated in row-major order
+            EXPECT_EQ(expected, nonzero(a));
+            EXPECT_EQ(expected, nonzero(a * 2));
+            EXPECT_EQ(expected_arg, argwhere<layout_type::row_major>(a));
+            EXPECT_EQ(expected_arg, argwhere<layout_type::row_major>(a > 0 || a < 0));
+
+            auto col_major = argwhere<layout_type::column_major>(a);
+            ASSERT_EQ(expected_arg.size(), col_major.size());
+            for (std::size_t n = 1; n < col_major.size(); ++n)
+            {
+                std::size_t prev = col_major[n - 1][0] + 4 * (col_major[n - 1][1] + 9 * col_major[n - 1][2]);
+                std::size_t cur = col_major[n][0] + 4 * (col_major[n][1] + 9 * col_major[n][2]);
+                EXPECT_LT(prev, cur);
+            }
+
+            std::vector<std::size_t> expected_flat;
+            for (std::size_t i = 0; i < a.size(); ++i)
+            {
+                if (a.flat(i) != 0)
+                {
+                    expected_flat.push_back(i);
+                }
+            }
+            EXPECT_EQ(expected_flat, flatnonzero<layout_type::column_major>(a));
+        }
+
+        TEST_CASE("nonzero_optional")
+        {
+            // the values under the missing flags are not read as non-zero
+            using opt_type = xoptional_assembly<xarray<int>, xarray<bool>>;
+            auto missing = xtl::missing<int>();
+            opt_type a = {{1, missing, 0}, {0, 2, missing}};
+            a.value()(0, 1) = 5;
+            a.value()(1, 2) = 7;
+            EXPECT_FALSE(detail::has_dense_values<opt_type>::value);
+
+            std::vector<std::vector<std::size_t>> expected = {{0, 1}, {0, 1}};
+            EXPECT_EQ(expected, nonzero(a));
+            std::vector<xindex_type_t<opt_type::shape_type>> expected_arg = {{0, 0}, {1, 1}};
+            EXPECT_EQ(expected_arg, argwhere(a));
+            std::vector<std::size_t> expected_flat = {0, 4};
+            EXPECT_EQ(expected_flat, flatnonzero<layout_type::row_major>(a));
+        }
+
+        TEST_CASE("any_all_blocks")
+        {
+            // several blocks, the deciding value lying in the last one
+            xtensor<int, 2> a = zeros<int>({3, 1000});
+            EXPECT_FALSE(any(a));
+            a(2, 999) = 1;
+            EXPECT_TRUE(any(a));
+            EXPECT_FALSE(all(a));
+            EXPECT_TRUE(any(view(a, all(), range(1, 1000, 2))));
+            EXPECT_FALSE(any(view(a, all(), range(0, 1000, 2))));
+            EXPECT_TRUE(any(transpose(a)));
+
+            xarray<double, layout_type::column_major> b = ones<double>({1000, 3});
+            EXPECT_TRUE(all(b));
+            b(999, 2) = 0.;
+            EXPECT_FALSE(all(b));
+            EXPECT_TRUE(all(view(b, range(0, 999), all())));
+            EXPECT_FALSE(all(b + 0.));
+            EXPECT_TRUE(all(b + 1.));
+
+            xtensor<bool, 1> c = xtensor<bool, 1>::from_shape({0});
+            EXPECT_FALSE(any(c));
+            EXPECT_TRUE(all(c));
+        }
+
         TEST_CASE_TEMPLATE("cast", TypeParam, XOPERATION_TEST_TYPES)
         {
             using int_container_t = xop_test::rebind_container_t<TypeParam, int>;
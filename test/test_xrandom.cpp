@@ -7,6 +7,8 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <algorithm>
+#include <cmath>
 #include <type_traits>
 
 #include "test_common_macros.hpp"
@@ -20,6 +22,7 @@
 #include "xtensor/xrandom.hpp"
 #endif
 #include "xtensor/xarray.hpp"
+#include "xtensor/xexecution.hpp"
 #include "xtensor/xview.hpp"
 #include "xtensor/xset_operation.hpp"
 
@@ -143,6 +146,111 @@ namespace xt
         ASSERT_NE(p1, p3);
     }
 
+    TEST(xrandom, philox)
+    {
+        // known answers of the Philox4x32-10 reference implementation
+        random::philox4x32 zero(0);
+        EXPECT_EQ(zero(), 0x6627e8d5u);
+        EXPECT_EQ(zero(), 0xe169c58du);
+        EXPECT_EQ(zero(), 0xbc57ac4cu);
+        EXPECT_EQ(zero(), 0x9b00dbd8u);
+
+        random::philox4x32 engine(0x299f31d0a4093822u);
+        engine.set_stream(0x0370734413198a2eu);
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            engine.discard(0x85a308d3243f6a88u);
+        }
+        EXPECT_EQ(engine(), 0xd16cfe09u);
+        EXPECT_EQ(engine(), 0x94fdccebu);
+
+        random::philox4x32 e1(7), e2(7);
+        for (std::size_t i = 0; i < 9; ++i)
+        {
+            e1();
+        }
+        e2.discard(9);
+        EXPECT_EQ(e1, e2);
+
+        random::philox4x32 seq_engine(42);
+        xarray<double> a = random::randn<double>({50, 40}, 0., 1., seq_engine);
+        xarray<double> b = random::rand<double>({7}, 0., 1., seq_engine);
+        EXPECT_EQ(seq_engine.stream(), std::uint64_t(2007));
+
+        // the values only depend on the seed and the position of the elements
+        random::philox4x32 par_engine(42);
+        {
+            execution::scoped_policy guard(execution::par.with_grain_size(16));
+            xarray<double> pa = random::randn<double>({50, 40}, 0., 1., par_engine);
+            xarray<double> pb = random::rand<double>({7}, 0., 1., par_engine);
+            EXPECT_EQ(a, pa);
+            EXPECT_EQ(b, pb);
+        }
+
+        random::philox4x32 lazy_engine(42);
+        xarray<double> la = random::randn<double>({50, 40}, 0., 1., lazy_engine) + 0.;
+        EXPECT_EQ(a, la);
+        EXPECT_NE(a(0, 0), a(0, 1));
+        EXPECT_NEAR(mean(a)(), 0., 0.1);
+        EXPECT_NEAR(stddev(a)(), 1., 0.1);
+    }
+
+    namespace
+    {
+        // Kolmogorov-Smirnov statistic of the sample against the cdf, scaled by
+        // sqrt(n): values above 1.63 reject the distribution at the 1% level
+        template <class C, class F>
+        double ks_statistic(const C& sample, F cdf)
+        {
+            std::vector<double> sorted(sample.cbegin(), sample.cend());
+            std::sort(sorted.begin(), sorted.end());
+            double n = double(sorted.size());
+            double res = 0.;
+            for (std::size_t i = 0; i < sorted.size(); ++i)
+            {
+                double c = cdf(sorted[i]);
+                res = (std::max)(res, (std::max)(std::fabs(c - double(i) / n), std::fabs(c - double(i + 1) / n)));
+            }
+            return res * std::sqrt(n);
+        }
+    }
+
+    // Quality of the simd samplers used with philox4x32: for each distribution,
+    // the values are checked to be reproducible for any execution policy and
+    // evaluation order, and a sample of 100000 values must pass a
+    // Kolmogorov-Smirnov test at the 1% level and have the expected moments.
+    TEST(xrandom, bulk_samplers)
+    {
+        const std::size_t n = 100000;
+        random::philox4x32 engine(1234);
+        xtensor<double, 1> normal = random::randn<double>({n}, 1., 2., engine);
+        xtensor<double, 1> expo = random::exponential<double>({n}, 4., engine);
+        xtensor<double, 1> logn = random::lognormal<double>({n}, 0., 0.5, engine);
+        xtensor<float, 1> fnormal = random::randn<float>({n}, 0.f, 1.f, engine);
+
+        random::philox4x32 par_engine(1234);
+        {
+            execution::scoped_policy guard(execution::par.with_grain_size(100));
+            xtensor<double, 1> par_normal = random::randn<double>({n}, 1., 2., par_engine);
+            EXPECT_EQ(normal, par_normal);
+        }
+        xtensor<double, 1> lazy_expo = random::exponential<double>({n}, 4., par_engine) + 0.;
+        EXPECT_EQ(expo, lazy_expo);
+
+        auto normal_cdf = [](double x) { return 0.5 * std::erfc(-x / std::sqrt(2.)); };
+        EXPECT_LT(ks_statistic((normal - 1.) / 2., normal_cdf), 1.63);
+        EXPECT_LT(ks_statistic(fnormal, normal_cdf), 1.63);
+        EXPECT_LT(ks_statistic(expo, [](double x) { return -std::expm1(-4. * x); }), 1.63);
+        EXPECT_LT(ks_statistic(log(logn) / 0.5, normal_cdf), 1.63);
+
+        EXPECT_NEAR(mean(normal)(), 1., 0.02);
+        EXPECT_NEAR(stddev(normal)(), 2., 0.02);
+        EXPECT_NEAR(mean(expo)(), 0.25, 0.005);
+        EXPECT_NEAR(mean(logn)(), std::exp(0.125), 0.01);
+        EXPECT_TRUE(all(expo >= 0.));
+        EXPECT_TRUE(all(isfinite(normal)));
+    }
+
     TEST(xrandom, choice)
     {
         xarray<double> a = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
@@ -161,6 +269,53 @@ namespace xt
         auto acr3 = xt::random::choice(a, 5, true);
         ASSERT_EQ(acr1, acr3);
         ASSERT_NE(acr1, acr2);
+
+        // few elements out of many are drawn with Floyd's algorithm
+        xarray<int> b = arange(1000);
+        xt::random::seed(42);
+        auto bc1 = xt::random::choice(b, 20, false);
+        auto bc2 = xt::random::choice(b, 20, false);
+        xt::random::seed(42);
+        auto bc3 = xt::random::choice(b, 20, false);
+        ASSERT_EQ(bc1, bc3);
+        ASSERT_NE(bc1, bc2);
+        ASSERT_TRUE(all(isin(bc1, b)));
+        std::sort(bc1.begin(), bc1.end());
+        EXPECT_TRUE(std::adjacent_find(bc1.begin(), bc1.end()) == bc1.end());
+        EXPECT_EQ(xt::random::choice(b, 0, false).size(), std::size_t(0));
+    }
+
+    TEST(xrandom, alias_sampler)
+    {
+        xarray<double> w = {1., 0., 2., 0., 4., 1.};
+        xt::random::alias_sampler<double> sampler(w);
+        EXPECT_EQ(sampler.size(), w.size());
+        EXPECT_TRUE(all(sampler.probabilities() >= 0.) && all(sampler.probabilities() <= 1.));
+        EXPECT_TRUE(all(sampler.aliases() < w.size()));
+
+        std::mt19937 engine(42);
+        std::size_t n = 100000;
+        auto indices = sampler.sample(n, engine);
+        ASSERT_EQ(indices.size(), n);
+        xtensor<double, 1> frequencies = zeros<double>({w.size()});
+        for (auto i : indices)
+        {
+            frequencies(i) += 1. / static_cast<double>(n);
+        }
+        EXPECT_TRUE(allclose(frequencies, w / sum(w)(), 0., 0.01));
+        EXPECT_EQ(frequencies(1), 0.);
+        EXPECT_EQ(frequencies(3), 0.);
+
+        for (std::size_t k = 0; k < 1000; ++k)
+        {
+            auto i = sampler(engine);
+            EXPECT_TRUE(w(i) > 0.);
+        }
+
+        engine.seed(42);
+        EXPECT_EQ(sampler.sample(n, engine), indices);
+
+        XT_EXPECT_THROW(xt::random::alias_sampler<double>(xarray<double>({0., 0.})), std::runtime_error);
     }
 
     TEST(xrandom, weighted_choice)
@@ -233,6 +388,51 @@ namespace xt
         EXPECT_FALSE(std::is_sorted(a.begin(), a.end()));
 #endif
 
+        // rows swapped in place match the generic swap of views
+        xarray<double> c = arange(105.).reshape({15, 7});
+        xarray<double, layout_type::column_major> cc = c;
+        xt::random::seed(7);
+        xt::random::shuffle(c);
+        xt::random::seed(7);
+        xt::random::shuffle(cc);
+        EXPECT_EQ(c, cc);
+    }
+
+    TEST(xrandom, permute_rows)
+    {
+        xarray<double> a = arange(60.).reshape({5, 3, 4});
+        xtensor<int, 1> perm = {3, 0, 4, 1, 2};
+        auto pa = xt::random::permute_rows(a, perm);
+        ASSERT_TRUE(same_shape(pa.shape(), a.shape()));
+        for (std::size_t k = 0; k < perm.size(); ++k)
+        {
+            EXPECT_EQ(view(pa, k), view(a, perm(k)));
+        }
+
+        xarray<double, layout_type::column_major> ca = a;
+        EXPECT_EQ(xt::random::permute_rows(ca, perm), pa);
+        EXPECT_EQ(xt::random::permute_rows(a + 1., perm), pa + 1.);
+
+        {
+            execution::scoped_policy guard(execution::par.with_grain_size(1));
+            EXPECT_EQ(xt::random::permute_rows(a, perm), pa);
+        }
+
+        xtensor<std::size_t, 1> rows = {4, 4};
+        auto ra = xt::random::permute_rows(a, rows);
+        EXPECT_EQ(ra.shape()[0], std::size_t(2));
+        EXPECT_EQ(view(ra, 1), view(a, 4));
+
+        xtensor<int, 1> out = {5};
+        XT_EXPECT_THROW(xt::random::permute_rows(a, out), std::out_of_range);
+        xtensor<int, 1> negative = {-1};
+        XT_EXPECT_THROW(xt::random::permute_rows(a, negative), std::out_of_range);
+
+        xt::random::seed(11);
+        auto p = xt::random::permutation(a.shape()[0]);
+        xt::random::seed(11);
+        xt::random::shuffle(a);
+        EXPECT_EQ(xt::random::permute_rows(xarray<double>(arange(60.).reshape({5, 3, 4})), p), a);
     }
 
     TEST(xrandom, permutation)
@@ -20,6 +20,7 @@
 #include "xtensor/xmath.hpp"
 #endif
 #include "xtensor/xutils.hpp"
+#include "xtensor/xexecution.hpp"
 #include "xtensor/xfixed.hpp"
 #include "xtensor/xbuilder.hpp"
 #include "xtensor/xreducer.hpp"
@@ -690,6 +691,109 @@ namespace xt
         EXPECT_EQ(minmax(input)(), (A{-1.0, 1.0}));
     }
 
+    TEST(xreducer, moments)
+    {
+        xarray<double> a = xt::random::rand<double>({4, 250, 3}, 0., 10.);
+        xarray<double> centered = a - xt::mean(a, {1}, keep_dims);
+        xarray<double> expected_var = xt::sum(centered * centered, {1}) / 250.;
+        xarray<double> expected_skew = xt::sum(xt::pow<3>(centered), {1}) / 250. / xt::pow(expected_var, 1.5);
+        xarray<double> expected_kurt = xt::sum(xt::pow<4>(centered), {1}) / 250. / (expected_var * expected_var) - 3.;
+
+        auto lazy = moments(a, {1});
+        auto immediate = moments(a, {1}, evaluation_strategy::immediate);
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                auto m = lazy(i, j);
+                EXPECT_EQ(m.count, 250.);
+                EXPECT_NEAR(m.variance(), expected_var(i, j), 1e-10);
+                EXPECT_NEAR(m.skewness(), expected_skew(i, j), 1e-10);
+                EXPECT_NEAR(m.kurtosis(), expected_kurt(i, j), 1e-10);
+                EXPECT_NEAR(immediate(i, j).variance(), expected_var(i, j), 1e-10);
+                EXPECT_NEAR(immediate(i, j).kurtosis(), expected_kurt(i, j), 1e-10);
+            }
+        }
+
+        xarray<double> var = xt::variance(a, {1});
+        EXPECT_TRUE(xt::allclose(var, expected_var));
+        xarray<double> var_ddof = xt::variance(a, {1}, 1);
+        EXPECT_TRUE(xt::allclose(var_ddof, expected_var * 250. / 249.));
+
+        // partial moments merged across blocks and threads
+        execution::scoped_policy guard(execution::par.with_grain_size(64));
+        auto all = moments(a, evaluation_strategy::immediate)();
+        double total_mean = xt::mean(a)();
+        EXPECT_EQ(all.count, 3000.);
+        EXPECT_NEAR(all.mean, total_mean, 1e-10);
+        EXPECT_NEAR(all.variance(), xt::mean(xt::square(a - total_mean))(), 1e-10);
+        EXPECT_NEAR(xt::stddev(a, evaluation_strategy::immediate)(), std::sqrt(all.variance()), 1e-10);
+    }
+
+    TEST(xreducer, variance_complex)
+    {
+        using cplx = std::complex<double>;
+        xarray<cplx> a = {{cplx(1., 1.), cplx(2., -1.), cplx(0., 3.)},
+                          {cplx(-1., 2.), cplx(3., 0.), cplx(1., -2.)}};
+
+        // like mean(square(a - mean(a))), the squares are not conjugated
+        cplx m(0., 0.);
+        for (const auto& v : a)
+        {
+            m += v;
+        }
+        m /= 6.;
+        cplx expected(0., 0.);
+        for (const auto& v : a)
+        {
+            expected += (v - m) * (v - m);
+        }
+        EXPECT_NEAR(std::abs(xt::variance(a)() - expected / 6.), 0., 1e-12);
+        EXPECT_NEAR(std::abs(xt::variance(a, 1u)() - expected / 5.), 0., 1e-12);
+
+        xarray<cplx> var = xt::variance(a, {1});
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            cplx row_mean = (a(i, 0) + a(i, 1) + a(i, 2)) / 3.;
+            cplx row_expected(0., 0.);
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                row_expected += (a(i, j) - row_mean) * (a(i, j) - row_mean);
+            }
+            EXPECT_NEAR(std::abs(var(i) - row_expected / 3.), 0., 1e-12);
+        }
+
+        xarray<int> b = {1, 2, 3, 4};
+        EXPECT_EQ(xt::variance(b)(), 1.25);
+    }
+
+    TEST(xreducer, variance_summation)
+    {
+        xarray<float> a = xt::ones<float>({2, 20000});
+        for (std::size_t j = 0; j < 20000; ++j)
+        {
+            a(0, j) += 0.001f * static_cast<float>(j % 7);
+            a(1, j) -= 0.002f * static_cast<float>(j % 5);
+        }
+        xarray<double> ad = xt::cast<double>(a);
+        xarray<double> centered = ad - xt::mean(ad, {1}, keep_dims);
+        xarray<double> expected = xt::sum(centered * centered, {1}) / 20000.;
+
+        xarray<float> vk = xt::variance(a, {1}, summation::kahan);
+        xarray<float> vp = xt::variance(a, {1}, summation::pairwise | evaluation_strategy::immediate);
+        xarray<float> sk = xt::stddev(a, {1}, summation::kahan);
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            EXPECT_NEAR(vk(i), expected(i), 1e-4 * expected(i));
+            EXPECT_NEAR(vp(i), expected(i), 1e-4 * expected(i));
+            EXPECT_NEAR(sk(i), std::sqrt(expected(i)), 1e-4 * std::sqrt(expected(i)));
+        }
+
+        double total_var = xt::mean(xt::square(ad - xt::mean(ad)()))();
+        EXPECT_NEAR(xt::variance(a, summation::kahan)(), total_var, 1e-4 * total_var);
+        EXPECT_NEAR(xt::variance(ad, summation::kahan)(), xt::variance(ad)(), 1e-12);
+    }
+
     TEST(xreducer, immediate)
     {
         xarray<double> a = xt::arange(27);
@@ -1082,4 +1186,89 @@ namespace xt
         xt::xtensor_fixed<float, xt::xshape<3>> res1 = res;
         EXPECT_EQ(res1, a * 2.);
     }
+
+    TEST(xreducer, immediate_full_reduction)
+    {
+        xt::xarray<double> a = xt::reshape_view(xt::arange<double>(10007.) - 5000., {10007, 1});
+        xt::xarray<int> b = xt::arange<int>(-51, 50);
+
+        for (std::size_t grain : std::vector<std::size_t>({1, 7, 128, 100000}))
+        {
+            execution::scoped_policy guard(execution::par.with_grain_size(grain));
+            EXPECT_EQ(xt::sum(a, xt::evaluation_strategy::immediate)(), xt::sum(a)());
+            EXPECT_EQ(xt::amin(a, xt::evaluation_strategy::immediate)(), -5000.);
+            EXPECT_EQ(xt::amax(a, xt::evaluation_strategy::immediate)(), 5006.);
+            EXPECT_EQ(xt::prod(b, xt::evaluation_strategy::immediate)(), 0);
+            EXPECT_EQ(xt::sum(b, xt::evaluation_strategy::immediate | initial(3))(), -98);
+            EXPECT_EQ(xt::norm_l1(a, xt::evaluation_strategy::immediate)(), xt::norm_l1(a)());
+            EXPECT_EQ(xt::norm_linf(b, xt::evaluation_strategy::immediate)(), 51);
+        }
+
+        xt::xarray<double> c = xt::ones<double>({3, 5});
+        EXPECT_EQ(xt::prod(2. * c, xt::evaluation_strategy::immediate)(), 32768.);
+    }
+
+    TEST(xreducer, contiguous_lazy_reduction)
+    {
+        xt::xarray<double> a = xt::reshape_view(xt::arange<double>(3 * 67 * 5), {3, 67, 5});
+        xt::xarray<double, layout_type::column_major> ca = a;
+        std::vector<std::vector<std::size_t>> axes_list = {{0}, {1}, {2}, {0, 1}, {1, 2}, {0, 2}};
+
+        for (const auto& axes : axes_list)
+        {
+            xt::xarray<double> expected = xt::sum(a + 0., axes);
+            xt::xarray<double> res = xt::sum(a, axes);
+            EXPECT_EQ(res, expected);
+            xt::xarray<double> cres = xt::sum(ca, axes);
+            EXPECT_EQ(cres, expected);
+
+            xt::xarray<double> kd_expected = xt::amax(a + 0., axes, xt::keep_dims | initial(500.));
+            xt::xarray<double> kd_res = xt::amax(a, axes, xt::keep_dims | initial(500.));
+            EXPECT_EQ(kd_res, kd_expected);
+        }
+
+        xt::xtensor<int, 2> b = {{1, -2, 3}, {4, 5, -6}};
+        xt::xtensor<int, 1> bres = xt::amin(b, {1});
+        EXPECT_EQ(bres, (xt::xtensor<int, 1>{-2, -6}));
+        bres = xt::prod(b, {0});
+        EXPECT_EQ(bres, (xt::xtensor<int, 1>{4, -10, -18}));
+    }
+
+    TEST(xreducer, compensated_summation)
+    {
+        // naive float32 sums of these arrays drift far away from the exact result
+        const std::size_t n = 300000;
+        const double expected = double(n) * double(0.1f);
+        xt::xtensor<float, 2> a = xt::ones<float>({std::size_t(3), n}) * 0.1f;
+        xt::xtensor<float, 2> b = xt::ones<float>({n, std::size_t(3)}) * 0.1f;
+
+        xt::xtensor<float, 1> rk = xt::sum(a, {1}, summation::kahan | evaluation_strategy::immediate);
+        xt::xtensor<float, 1> rp = xt::sum(a, {1}, summation::pairwise | evaluation_strategy::immediate);
+        xt::xtensor<float, 1> ck = xt::sum(b, {0}, summation::kahan | evaluation_strategy::immediate);
+        xt::xtensor<float, 1> cp = xt::sum(b, {0}, summation::pairwise | evaluation_strategy::immediate);
+        xt::xtensor<float, 1> lk = xt::sum(a + 0.f, {1}, summation::kahan);
+        xt::xtensor<float, 1> lp = xt::sum(a + 0.f, {1}, summation::pairwise);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            EXPECT_NEAR(rk(i), expected, expected * 1e-6);
+            EXPECT_NEAR(rp(i), expected, expected * 1e-6);
+            EXPECT_NEAR(ck(i), expected, expected * 1e-6);
+            EXPECT_NEAR(cp(i), expected, expected * 1e-6);
+            EXPECT_NEAR(lk(i), expected, expected * 1e-6);
+            EXPECT_NEAR(lp(i), expected, expected * 1e-6);
+        }
+
+        EXPECT_NEAR(xt::sum(a, summation::kahan)(), 3. * expected, 3. * expected * 1e-6);
+        EXPECT_NEAR(xt::sum(a, summation::pairwise | evaluation_strategy::immediate)(), 3. * expected, 3. * expected * 1e-6);
+
+        xt::xtensor<float, 1> m = xt::mean(a, {1}, summation::kahan);
+        EXPECT_NEAR(m(0), 0.1f, 1e-7);
+        xt::xtensor<float, 1> v = xt::variance(b, {0}, summation::kahan);
+        EXPECT_NEAR(v(2), 0.f, 1e-7);
+
+        // integral sums are not affected
+        xt::xarray<int> c = {{1, 2, 3}, {4, 5, 6}};
+        xt::xarray<int> ci = xt::sum(c, {1}, summation::kahan);
+        EXPECT_EQ(ci, (xt::xarray<int>{6, 15}));
+    }
 }
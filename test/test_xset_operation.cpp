@@ -9,9 +9,12 @@
 
 #include "test_common_macros.hpp"
 
+#include <cmath>
 #include <cstddef>
+#include <vector>
 
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xset_operation.hpp"
 
@@ -37,6 +40,42 @@ namespace xt
         EXPECT_EQ(xt::in1d(a, {1, 2}), res);
     }
 
+    TEST(xset_operation, isin_options)
+    {
+        xt::xtensor<int,2> a = {{1, 2, 1}, {0, 3, 1}};
+        xt::xtensor<int,1> b = {2, 1, 2};
+        xt::xtensor<bool,2> res = {{true, true, true}, {false, false, true}};
+        xt::xtensor<bool,2> inv = {{false, false, false}, {true, true, false}};
+        EXPECT_EQ(xt::isin(a, b, false, true), inv);
+        EXPECT_EQ(xt::isin(a, b.begin(), b.end(), false, true), inv);
+        EXPECT_EQ(xt::isin(a, {1, 2}, true, true), inv);
+        EXPECT_EQ(xt::in1d(xt::xtensor<int,1>{1, 0}, {1, 2}, true, true), (xt::xtensor<bool,1>{false, true}));
+
+        // mixed types are compared after promotion, as with operator==
+        xt::xtensor<double,2> ad = {{1., 2.5, 1.}, {0., 3., 1.}};
+        xt::xtensor<bool,2> res_d = {{true, false, true}, {false, false, true}};
+        EXPECT_EQ(xt::isin(ad, b), res_d);
+
+        xt::xtensor<double,1> d = {0., -0., std::nan(""), 1.};
+        xt::xtensor<bool,1> res_nan = {true, true, false, false};
+        EXPECT_EQ(xt::isin(d, {-0., std::nan("")}), res_nan);
+        EXPECT_EQ(xt::isin(a, std::vector<int>()), xt::zeros<bool>(a.shape()));
+    }
+
+    TEST(xset_operation, isin_large)
+    {
+        std::size_t n = 1000;
+        xt::xtensor<int,1> test_elements = xt::arange<int>(0, 3 * int(n), 3);
+        xt::xtensor<int,1> a = xt::arange<int>(-10, 4 * int(n));
+        xt::xtensor<bool,1> res = xt::isin(a, test_elements);
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            bool expected = a(i) >= 0 && a(i) < 3 * int(n) && a(i) % 3 == 0;
+            EXPECT_EQ(res(i), expected);
+        }
+        EXPECT_EQ(xt::isin(a, test_elements, true, true), !res);
+    }
+
     TEST(xset_operation, searchsorted)
     {
         xt::xtensor<size_t,1> a = {1, 2, 7, 8, 20};
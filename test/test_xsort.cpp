@@ -7,12 +7,22 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <tuple>
+
 #include "test_common_macros.hpp"
 #include "xtensor/xadapt.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xexecution.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xfixed.hpp"
 #include "xtensor/xio.hpp"
+#include "xtensor/xmath.hpp"
 #include "xtensor/xinfo.hpp"
 #include "xtensor/xview.hpp"
 #include "xtensor/xrandom.hpp"
@@ -244,6 +254,173 @@ namespace xt
         }
     }
 
+    TEST(xsort, parallel_sort)
+    {
+        xarray<int> a = xt::random::randint<int>({40, 3, 50}, -100, 100);
+        xarray<int, layout_type::column_major> ca = a;
+        xarray<int> flat = xt::random::randint<int>({10007}, -1000, 1000);
+
+        std::vector<xarray<int>> expected;
+        std::vector<xarray<std::size_t>> expected_args;
+        for (std::ptrdiff_t ax = 0; ax < 3; ++ax)
+        {
+            expected.push_back(sort(a, ax));
+            expected_args.push_back(argsort(a, ax));
+        }
+        xarray<int> expected_flat = sort(flat);
+        xarray<int> expected_partition = partition(a, 10, 0);
+
+        for (std::size_t grain : {std::size_t(1), std::size_t(7), std::size_t(100), std::size_t(2000)})
+        {
+            execution::scoped_policy guard(execution::par.with_grain_size(grain));
+            for (std::ptrdiff_t ax = 0; ax < 3; ++ax)
+            {
+                EXPECT_EQ(sort(a, ax), expected[std::size_t(ax)]);
+                EXPECT_EQ(argsort(a, ax), expected_args[std::size_t(ax)]);
+                EXPECT_EQ(xarray<int>(sort(ca, ax)), expected[std::size_t(ax)]);
+            }
+            EXPECT_EQ(sort(flat), expected_flat);
+            xarray<int> part = partition(a, 10, 0);
+            EXPECT_EQ(xt::view(part, 10), xt::view(expected_partition, 10));
+        }
+    }
+
+    template <class T>
+    void check_radix_sort(const xarray<T>& a)
+    {
+        std::vector<T> values(a.cbegin(), a.cend());
+        std::vector<std::size_t> indices(values.size());
+        std::iota(indices.begin(), indices.end(), std::size_t(0));
+        std::stable_sort(indices.begin(), indices.end(), [&values](std::size_t x, std::size_t y) {
+            return values[x] < values[y];
+        });
+        std::sort(values.begin(), values.end());
+
+        xarray<T> sorted = sort(a);
+        EXPECT_TRUE(std::equal(values.cbegin(), values.cend(), sorted.cbegin()));
+        xarray<std::size_t> args = argsort(a, -1, sorting_method::stable);
+        EXPECT_TRUE(std::equal(indices.cbegin(), indices.cend(), args.cbegin()));
+        xarray<std::size_t> flat_args = argsort(a, xnone(), sorting_method::stable);
+        EXPECT_TRUE(std::equal(indices.cbegin(), indices.cend(), flat_args.cbegin()));
+    }
+
+    TEST(xsort, radix_sort)
+    {
+        std::size_t n = 3 * XTENSOR_RADIX_SORT_THRESHOLD + 17;
+        check_radix_sort<int>(xt::random::randint<int>({n}, -1000, 1000));
+        check_radix_sort<std::uint32_t>(xt::random::randint<std::uint32_t>({n}, 0, 4000000000u));
+        check_radix_sort<std::int64_t>(xt::random::randint<std::int64_t>({n}, -(std::int64_t(1) << 40), std::int64_t(1) << 40));
+        check_radix_sort<std::int8_t>(xt::cast<std::int8_t>(xt::random::randint<int>({n}, -128, 127)));
+        check_radix_sort<float>(xt::random::randn<float>({n}));
+        // many ties, including -0.0 and 0.0
+        xarray<double> d = xt::round(xt::random::randn<double>({n}) * 4.);
+        check_radix_sort<double>(d);
+
+        xarray<double> nans = xt::random::randn<double>({n});
+        nans(0) = std::numeric_limits<double>::quiet_NaN();
+        nans(n / 2) = -std::numeric_limits<double>::infinity();
+        nans(n - 1) = std::numeric_limits<double>::quiet_NaN();
+        xarray<double> sorted_nans = sort(nans);
+        EXPECT_EQ(sorted_nans(0), -std::numeric_limits<double>::infinity());
+        EXPECT_TRUE(std::is_sorted(sorted_nans.cbegin(), sorted_nans.cend() - 2));
+        EXPECT_TRUE(std::isnan(sorted_nans(n - 2)));
+        EXPECT_TRUE(std::isnan(sorted_nans(n - 1)));
+        xarray<std::size_t> nan_args = argsort(nans);
+        EXPECT_EQ(nan_args(n - 2), std::size_t(0));
+        EXPECT_EQ(nan_args(n - 1), n - 1);
+
+        xarray<int> lanes = xt::random::randint<int>({3, n}, -50, 50);
+        xarray<std::size_t> lane_args = argsort(lanes, 1, sorting_method::stable);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            auto lane = xt::view(lanes, i);
+            auto lane_arg = xt::view(lane_args, i);
+            for (std::size_t j = 1; j < n; ++j)
+            {
+                int prev = lane(lane_arg(j - 1));
+                int cur = lane(lane_arg(j));
+                EXPECT_TRUE(prev < cur || (prev == cur && lane_arg(j - 1) < lane_arg(j)));
+            }
+        }
+    }
+
+    TEST(xsort, sort_nan_last)
+    {
+        // the same order below and above the radix sort threshold
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        for (std::size_t n : {std::size_t(7), std::size_t(2 * XTENSOR_RADIX_SORT_THRESHOLD + 7)})
+        {
+            xtensor<double, 2> a = xt::random::randn<double>({2, n});
+            a(0, 0) = nan;
+            a(0, n / 2) = nan;
+            a(1, n - 1) = nan;
+
+            xtensor<double, 2> sorted = sort(a, 1);
+            EXPECT_TRUE(std::is_sorted(&sorted(0, 0), &sorted(0, n - 2)));
+            EXPECT_TRUE(std::isnan(sorted(0, n - 2)));
+            EXPECT_TRUE(std::isnan(sorted(0, n - 1)));
+            EXPECT_TRUE(std::is_sorted(&sorted(1, 0), &sorted(1, n - 1)));
+            EXPECT_TRUE(std::isnan(sorted(1, n - 1)));
+
+            xtensor<double, 1> flat_sorted = sort(a, xnone());
+            EXPECT_TRUE(std::is_sorted(flat_sorted.cbegin(), flat_sorted.cend() - 3));
+            EXPECT_TRUE(std::all_of(flat_sorted.cend() - 3, flat_sorted.cend(), [](double v) { return std::isnan(v); }));
+
+            for (auto method : {sorting_method::quick, sorting_method::stable})
+            {
+                xtensor<std::size_t, 2> args = argsort(a, 1, method);
+                EXPECT_EQ(args(1, n - 1), n - 1);
+                EXPECT_TRUE(std::isnan(a(0, args(0, n - 2))));
+                EXPECT_TRUE(std::isnan(a(0, args(0, n - 1))));
+            }
+            xtensor<std::size_t, 2> stable_args = argsort(a, 1, sorting_method::stable);
+            EXPECT_EQ(stable_args(0, n - 2), std::size_t(0));
+            EXPECT_EQ(stable_args(0, n - 1), n / 2);
+        }
+    }
+
+    TEST(xsort, stable_argsort)
+    {
+        xarray<int> a = {3, 1, 2, 1, 3, 1, 2};
+        xarray<std::size_t> expected = {1, 3, 5, 2, 6, 0, 4};
+        EXPECT_EQ(argsort(a, -1, sorting_method::stable), expected);
+        EXPECT_EQ(argsort(a, xnone(), sorting_method::stable), expected);
+
+        xarray<std::string> s = {"b", "a", "b", "a"};
+        xarray<std::size_t> expected_s = {1, 3, 0, 2};
+        EXPECT_EQ(argsort(s, -1, sorting_method::stable), expected_s);
+    }
+
+    TEST(xsort, lexsort)
+    {
+        // numpy.lexsort((b, a)): sort by a, then by b
+        xarray<int> a = {1, 5, 1, 4, 3, 4, 4};
+        xarray<int> b = {9, 4, 0, 4, 0, 2, 1};
+        xtensor<std::size_t, 1> expected = {2, 0, 4, 6, 5, 3, 1};
+        EXPECT_EQ(lexsort(b, a), expected);
+        EXPECT_EQ(lexsort(a), argsort(a, -1, sorting_method::stable));
+
+        xarray<std::string> names = {"b", "a", "b", "a"};
+        xarray<double> values = {2., 1., 1., 1.};
+        xtensor<std::size_t, 1> expected_mixed = {1, 3, 2, 0};
+        EXPECT_EQ(lexsort(values, names), expected_mixed);
+
+        std::size_t n = 2 * XTENSOR_RADIX_SORT_THRESHOLD;
+        xarray<int> k0 = xt::random::randint<int>({n}, 0, 1000);
+        xarray<int> k1 = xt::random::randint<int>({n}, 0, 10);
+        xarray<double> k2 = xt::random::randint<int>({n}, 0, 10);
+        xtensor<std::size_t, 1> res = lexsort(k0, k1, k2 * 2.);
+        for (std::size_t i = 1; i < n; ++i)
+        {
+            auto prev = std::make_tuple(k2(res(i - 1)), k1(res(i - 1)), k0(res(i - 1)), res(i - 1));
+            auto cur = std::make_tuple(k2(res(i)), k1(res(i)), k0(res(i)), res(i));
+            EXPECT_TRUE(prev < cur);
+        }
+
+        xarray<int> short_key = {1, 2};
+        XT_EXPECT_ANY_THROW(lexsort(a, short_key));
+    }
+
     TEST(xsort, argmax_prob)
     {
         for (std::size_t i = 0; i < 20; ++i)
@@ -280,6 +457,200 @@ namespace xt
         }
     }
 
+    TEST(xsort, argminmax)
+    {
+        xarray<double> a = {{3., 1., 4., 1.}, {5., 9., 2., 6.}, {5., 3., 5., 9.}};
+        auto flat = argminmax(a);
+        EXPECT_EQ(argmin(a), flat.first);
+        EXPECT_EQ(argmax(a), flat.second);
+
+        for (std::ptrdiff_t axis = 0; axis < 2; ++axis)
+        {
+            auto res = argminmax(a, axis);
+            EXPECT_EQ(argmin(a, axis), res.first);
+            EXPECT_EQ(argmax(a, axis), res.second);
+        }
+
+        // NaNs never compare, results match a sequential scan
+        xarray<double> b = {{1., NAN, 0.}, {NAN, 2., -1.}};
+        EXPECT_EQ(size_t(5), argmin(b)());
+        xtensor<size_t, 1> ex_min = {0, 0, 1};
+        xtensor<size_t, 1> ex_max = {0, 0, 0};
+        EXPECT_EQ(ex_min, argmin(b, 0));
+        EXPECT_EQ(ex_max, argmax(b, 0));
+
+        xarray<double> empty = xarray<double>::from_shape({0, 3});
+        XT_EXPECT_ANY_THROW(argmin(empty));
+        XT_EXPECT_ANY_THROW(argmax(empty, 0));
+    }
+
+    template <layout_type L, class T>
+    void check_argminmax_axis(const std::vector<std::size_t>& shape)
+    {
+        xarray<T, L> a = xt::cast<T>(xt::random::randint<int>(shape, -50, 50));
+        for (std::size_t axis = 0; axis < a.dimension(); ++axis)
+        {
+            auto res = argminmax(a, static_cast<std::ptrdiff_t>(axis));
+            auto min_lanes = xt::amin(a, {axis});
+            auto max_lanes = xt::amax(a, {axis});
+            xarray<T> expected_min = min_lanes;
+            xarray<T> expected_max = max_lanes;
+            for (std::size_t i = 0; i < res.first.size(); ++i)
+            {
+                auto idx = unravel_index(i, res.first.shape());
+                std::vector<std::size_t> pos(idx.begin(), idx.end());
+                pos.insert(pos.begin() + static_cast<std::ptrdiff_t>(axis), res.first.flat(i));
+                EXPECT_EQ(expected_min.flat(i), a.element(pos.begin(), pos.end()));
+                pos[axis] = res.second.flat(i);
+                EXPECT_EQ(expected_max.flat(i), a.element(pos.begin(), pos.end()));
+
+                // the first occurrence along the lane must be reported
+                for (std::size_t k = 0; k < res.first.flat(i); ++k)
+                {
+                    pos[axis] = k;
+                    EXPECT_NE(expected_min.flat(i), a.element(pos.begin(), pos.end()));
+                }
+            }
+        }
+    }
+
+    TEST(xsort, argminmax_axis)
+    {
+        check_argminmax_axis<layout_type::row_major, double>({300, 37});
+        check_argminmax_axis<layout_type::column_major, double>({300, 37});
+        check_argminmax_axis<layout_type::row_major, float>({3, 70, 17});
+        check_argminmax_axis<layout_type::column_major, int>({5, 4, 130});
+        check_argminmax_axis<layout_type::row_major, std::int8_t>({600, 40});
+    }
+
+    TEST(xsort, argminmax_strided_adaptor)
+    {
+        std::vector<double> buffer = {5., -100., 3., 100., 8., 0., 2., 0., 9., 0.,
+                                      4., 0., 7., 0., 6., 0., 1.5, 0., 6.5, 0.};
+        using shape_type = std::vector<std::size_t>;
+        shape_type shape = {10};
+        shape_type strides = {2};
+        auto a = adapt(buffer.data(), buffer.size(), no_ownership(), shape, strides);
+
+        EXPECT_EQ(argmin(a)(), 8u);
+        EXPECT_EQ(argmax(a)(), 4u);
+        auto res = argminmax(a);
+        EXPECT_EQ(res.first(), 8u);
+        EXPECT_EQ(res.second(), 4u);
+    }
+
+    TEST(xsort, topk)
+    {
+        xarray<int> a = {{3, 1, 4, 1, 5}, {9, 2, 6, 5, 3}};
+
+        auto largest = topk(a, 2);
+        xarray<int> ex_values = {{5, 4}, {9, 6}};
+        xarray<std::size_t> ex_indices = {{4, 2}, {0, 2}};
+        EXPECT_EQ(ex_values, largest.first);
+        EXPECT_EQ(ex_indices, largest.second);
+
+        // equal values are returned by increasing index
+        auto smallest = topk(a, 3, 1, false);
+        xarray<int> ex_small_values = {{1, 1, 3}, {2, 3, 5}};
+        xarray<std::size_t> ex_small_indices = {{1, 3, 0}, {1, 4, 3}};
+        EXPECT_EQ(ex_small_values, smallest.first);
+        EXPECT_EQ(ex_small_indices, smallest.second);
+
+        auto along_0 = topk(a, 1, 0);
+        xarray<int> ex_0 = {{9, 2, 6, 5, 5}};
+        xarray<std::size_t> ex_0_indices = {{1, 1, 1, 1, 0}};
+        EXPECT_EQ(ex_0, along_0.first);
+        EXPECT_EQ(ex_0_indices, along_0.second);
+
+        EXPECT_EQ(std::size_t(0), topk(a, 0).first.size());
+        XT_EXPECT_ANY_THROW(topk(a, 6));
+
+        xtensor<double, 1> b = {1., NAN, 3., 2.};
+        xtensor<double, 1> ex_b = {1., 2.};
+        EXPECT_EQ(ex_b, topk(b, 2, 0, false).first);
+        EXPECT_TRUE(std::isnan(topk(b, 1).first(0)));
+    }
+
+    TEST(xsort, topk_large)
+    {
+        // compares the heap and selection kernels with a stable argsort
+        xarray<int, layout_type::column_major> a = xt::random::randint<int>({300, 4}, 0, 50);
+        auto order = argsort(xt::eval(-a), 0, sorting_method::stable);
+        for (std::size_t k : {std::size_t(5), std::size_t(100), std::size_t(300)})
+        {
+            auto res = topk(a, k, 0);
+            EXPECT_EQ(xarray<std::size_t>(view(order, range(0, k), all())), res.second);
+
+            auto unsorted = topk(a, k, 0, true, false);
+            EXPECT_EQ(sort(res.first, 0), sort(unsorted.first, 0));
+        }
+    }
+
+    TEST(xsort, quantile)
+    {
+        xarray<double> a = {{1., 2., 3., 4.}, {10., 20., 30., 40.}};
+
+        auto flat = quantile(a, {0., 0.25, 1.});
+        xtensor<double, 1> ex_flat = {1., 2.75, 40.};
+        EXPECT_EQ(ex_flat, flat);
+
+        xarray<double> ex_1 = {{2.5, 25.}};
+        EXPECT_EQ(ex_1, quantile(a, {0.5}, 1));
+        xarray<double> ex_0 = {{5.5, 11., 16.5, 22.}};
+        EXPECT_EQ(ex_0, quantile(a, {0.5}, 0));
+        EXPECT_EQ(ex_0, quantile(a, std::vector<double>({0.5}), -2));
+
+        xtensor<int, 1> b = {4, 1, 3, 2};
+        EXPECT_DOUBLE_EQ(2.2, quantile(b, {0.4})(0));
+        EXPECT_EQ(2., quantile(b, {0.4}, quantile_method::lower)(0));
+        EXPECT_EQ(3., quantile(b, {0.4}, quantile_method::higher)(0));
+        EXPECT_EQ(2.5, quantile(b, {0.4}, quantile_method::midpoint)(0));
+        EXPECT_EQ(2., quantile(b, {0.4}, quantile_method::nearest)(0));
+        EXPECT_EQ(3., quantile(b, {0.5}, quantile_method::nearest)(0));
+        XT_EXPECT_ANY_THROW(quantile(b, {1.5}));
+
+        xtensor<double, 2> c = {{1., NAN, 3.}, {NAN, NAN, NAN}};
+        EXPECT_TRUE(std::isnan(quantile(c, {0.5})(0)));
+        EXPECT_EQ(2., nanquantile(c, {0.5})(0));
+        auto nan_lanes = nanquantile(c, {0.5}, 1);
+        EXPECT_EQ(2., nan_lanes(0, 0));
+        EXPECT_TRUE(std::isnan(nan_lanes(0, 1)));
+    }
+
+    TEST(xsort, quantile_strided_adaptor)
+    {
+        std::vector<double> buffer = {4., 100., 1., 100., 3., 100., 2., 100.};
+        using shape_type = std::vector<std::size_t>;
+        shape_type shape = {4};
+        shape_type strides = {2};
+        auto a = adapt(buffer.data(), buffer.size(), no_ownership(), shape, strides);
+
+        xtensor<double, 1> expected = {1., 2.5, 4.};
+        EXPECT_EQ(expected, quantile(a, {0., 0.5, 1.}));
+    }
+
+    TEST(xsort, quantile_lanes)
+    {
+        xarray<double, layout_type::column_major> a = xt::random::rand<double>({4, 9, 5});
+        std::vector<double> qs = {0.1, 0.5, 0.9, 0.5};
+        auto res = quantile(a, qs, 1);
+        ASSERT_EQ(std::vector<std::size_t>({4, 4, 5}), std::vector<std::size_t>(res.shape().begin(), res.shape().end()));
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            for (std::size_t k = 0; k < 5; ++k)
+            {
+                xtensor<double, 1> lane = sort(xtensor<double, 1>(view(a, i, all(), k)));
+                for (std::size_t j = 0; j < qs.size(); ++j)
+                {
+                    double h = qs[j] * 8.;
+                    std::size_t lo = static_cast<std::size_t>(h);
+                    double expected = lane(lo) + (lane(lo + 1) - lane(lo)) * (h - static_cast<double>(lo));
+                    EXPECT_NEAR(expected, res(j, i, k), 1e-12);
+                }
+            }
+        }
+    }
+
     TEST(xsort, unique)
     {
         xarray<double> a = {1,2,3, 5,3,2,1,2,2,2,2,2,2, 45};
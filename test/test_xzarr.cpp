@@ -0,0 +1,161 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test_common_macros.hpp"
+
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xexecution.hpp"
+#include "xtensor/xzarr.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        // inverts the bits of the chunks, for testing codecs
+        class xinvert_codec
+        {
+        public:
+
+            std::string id() const
+            {
+                return "invert";
+            }
+
+            std::string config() const
+            {
+                return "{\"id\": \"invert\"}";
+            }
+
+            void encode(const char* data, std::size_t size, std::ostream& stream) const
+            {
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    stream.put(static_cast<char>(~data[i]));
+                }
+            }
+
+            bool decode(std::istream& stream, char* data, std::size_t size) const
+            {
+                if (!xraw_codec().decode(stream, data, size))
+                {
+                    return false;
+                }
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    data[i] = static_cast<char>(~data[i]);
+                }
+                return true;
+            }
+        };
+
+        std::string read_file(const std::string& path)
+        {
+            std::ifstream stream(path, std::ifstream::binary);
+            std::stringstream buffer;
+            buffer << stream.rdbuf();
+            return buffer.str();
+        }
+
+        template <class CS>
+        void remove_zarr(const xchunked_array<CS>& a)
+        {
+            for (std::size_t i = 0; i < a.grid_size(); ++i)
+            {
+                std::remove(a.chunks().chunk_path(i).c_str());
+            }
+            std::remove((a.chunks().directory() + "/.zarray").c_str());
+            std::remove(a.chunks().directory().c_str());
+        }
+    }
+
+    TEST(xzarr, dump_and_load)
+    {
+        std::string path = "xzarr_files.zarr";
+        xarray<double> b = arange(1000.).reshape({10, 10, 10});
+        {
+            execution::scoped_policy guard(execution::par.with_grain_size(1));
+            dump_zarr(path, b, {3, 4, 5});
+        }
+
+        std::string metadata = read_file(path + "/.zarray");
+        EXPECT_NE(metadata.find("\"zarr_format\": 2"), std::string::npos);
+        EXPECT_NE(metadata.find("\"chunks\": [3, 4, 5]"), std::string::npos);
+        EXPECT_NE(metadata.find("\"shape\": [10, 10, 10]"), std::string::npos);
+        EXPECT_NE(metadata.find("\"compressor\": null"), std::string::npos);
+        EXPECT_NE(metadata.find("\"order\": \"C\""), std::string::npos);
+
+        // border chunks are padded to the chunk shape
+        EXPECT_EQ(read_file(path + "/3.2.1").size(), std::size_t(3 * 4 * 5) * sizeof(double));
+
+        {
+            auto a = load_zarr<double>(path, 2);
+            EXPECT_TRUE(same_shape(a.shape(), b.shape()));
+            EXPECT_TRUE(same_shape(a.chunk_shape(), std::vector<std::size_t>({3, 4, 5})));
+            EXPECT_EQ(a, b);
+            a(9, 9, 9) = -1.;
+        }
+
+        const auto a = load_zarr<double>(path, 1, true);
+        b(9, 9, 9) = -1.;
+        EXPECT_EQ(a, b);
+
+        XT_EXPECT_THROW(load_zarr<float>(path), std::runtime_error);
+        XT_EXPECT_THROW((load_zarr<double, layout_type::column_major>(path)), std::runtime_error);
+        XT_EXPECT_THROW(load_zarr<double>(path, 1, false, xinvert_codec()), std::runtime_error);
+        remove_zarr(a);
+    }
+
+    TEST(xzarr, codec)
+    {
+        std::string path = "xzarr_codec_files.zarr";
+        xarray<int, layout_type::column_major> b = arange(35).reshape({7, 5});
+        dump_zarr<layout_type::column_major>(path, b + 1, std::vector<std::size_t>({3, 2}), xinvert_codec());
+
+        std::string metadata = read_file(path + "/.zarray");
+        EXPECT_NE(metadata.find("\"compressor\": {\"id\": \"invert\"}"), std::string::npos);
+        EXPECT_NE(metadata.find("\"order\": \"F\""), std::string::npos);
+        std::string chunk = read_file(path + "/0.0");
+        EXPECT_EQ(chunk.size(), std::size_t(6) * sizeof(int));
+        EXPECT_EQ(static_cast<char>(~chunk[0]), char(1));
+
+        const auto a = load_zarr<int, layout_type::column_major>(path, 1, false, xinvert_codec());
+        EXPECT_EQ(a, b + 1);
+        XT_EXPECT_THROW((load_zarr<int, layout_type::column_major>(path)), std::runtime_error);
+        remove_zarr(a);
+    }
+
+    TEST(xzarr, metadata)
+    {
+        std::string path = "xzarr_metadata_files.zarr";
+        {
+            auto a = chunked_file_array<double>({4, 3}, {2, 2}, path);
+            a(3, 2) = 5.;
+        }
+        {
+            std::ofstream stream(path + "/.zarray");
+            stream << "{\"chunks\":[2,2],\"compressor\":null,\"dtype\":\""
+                   << detail::build_typestring<double>()
+                   << "\",\"fill_value\":\"NaN\",\"filters\":null,\"order\":\"C\",\"shape\":[4,3],\"zarr_format\":2}";
+        }
+
+        const auto a = load_zarr<double>(path);
+        EXPECT_TRUE(same_shape(a.shape(), std::vector<std::size_t>({4, 3})));
+        EXPECT_TRUE(std::isnan(a(0, 0)));
+        EXPECT_EQ(a(3, 2), 5.);
+        EXPECT_EQ(a(2, 2), 0.);
+        remove_zarr(a);
+    }
+}